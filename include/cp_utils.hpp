@@ -14,6 +14,7 @@
 #else
 // Individual includes for portability
 #include <algorithm>
+#include <atomic>
 #include <array>
 #include <bitset>
 #include <cassert>
@@ -59,6 +60,7 @@
 #include <stdexcept>
 #include <streambuf>
 #include <string>
+#include <thread>
 #include <typeinfo>
 #include <unordered_map>
 #include <unordered_set>
@@ -104,6 +106,20 @@
 #define HAS_GNU_PBDS
 #endif
 
+// POSIX file I/O (mmap/read) for the buffered reader - only include if available
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<unistd.h>)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HAS_POSIX_IO
+#endif
+
+// x86 SIMD intrinsics - used when compiled with -mavx2 (or an equivalent target pragma)
+#if defined(__AVX2__) && __has_include(<immintrin.h>)
+#include <immintrin.h>
+#define HAS_AVX2
+#endif
+
 #include "debug_utils.hpp" // Include the debug header
 
 using namespace std;
@@ -166,7 +182,8 @@ struct ModularOps
 
     static ll normalize(ll a)
     {
-        return (a % Modulus + Modulus) % Modulus;
+        a %= Modulus;
+        return a < 0 ? a + Modulus : a;
     }
 
     static ll add(ll a, ll b)
@@ -198,9 +215,20 @@ struct ModularOps
         return res;
     }
 
+    // Modular inverse via the extended Euclidean algorithm (n must be coprime to Modulus)
     static ll inv(ll n)
     {
-        return power(n, Modulus - 2);
+        ll a = normalize(n), b = Modulus, x = 1, y = 0;
+        while (b != 0)
+        {
+            ll q = a / b;
+            a -= q * b;
+            swap(a, b);
+            x -= q * y;
+            swap(x, y);
+        }
+        ASSERT(a == 1, "ModularOps::inv: Value is not invertible modulo Modulus.");
+        return normalize(x);
     }
 
     static ll div(ll a, ll b)
@@ -212,6 +240,158 @@ struct ModularOps
 using Mint = ModularOps<MOD_CONST>;
 using Mint1 = ModularOps<MOD1_CONST>;
 
+// Division-free modular integers for moduli below 2^31.
+// Both types share one interface (val(), + - * /, pow, inv) so hot loops can swap them freely:
+//   - MontgomeryModInt: odd moduli, stores x * 2^32 mod M; a multiply is three integer multiplies.
+//   - BarrettModInt: any modulus, stores x itself; a multiply reduces with a precomputed 2^64 / M.
+// ModInt<M> picks Montgomery for odd M and Barrett otherwise.
+template <uint32_t Mod>
+struct MontgomeryModInt
+{
+    static_assert(Mod % 2 == 1 && Mod < (1u << 31), "MontgomeryModInt needs an odd modulus below 2^31.");
+
+    static constexpr uint32_t _neg_inv()
+    { // -Mod^{-1} mod 2^32 by Newton iteration
+        uint32_t x = Mod;
+        for (int i = 0; i < 5; i++)
+            x *= 2 - Mod * x;
+        return -x;
+    }
+    static constexpr uint32_t NEG_INV = _neg_inv();
+    static constexpr uint32_t R2 = static_cast<uint32_t>((0ULL - Mod) % Mod); // 2^64 mod Mod
+
+    uint32_t v = 0; // Montgomery form
+
+    static constexpr uint32_t reduce(uint64_t t)
+    { // t * 2^-32 mod Mod, for t < Mod * 2^32
+        uint32_t m = static_cast<uint32_t>(t) * NEG_INV;
+        uint32_t u = static_cast<uint32_t>((t + static_cast<uint64_t>(m) * Mod) >> 32);
+        return u >= Mod ? u - Mod : u;
+    }
+
+    constexpr MontgomeryModInt() = default;
+    constexpr MontgomeryModInt(ll x)
+    {
+        x %= static_cast<ll>(Mod);
+        if (x < 0)
+            x += Mod;
+        v = reduce(static_cast<uint64_t>(x) * R2);
+    }
+
+    static constexpr uint32_t mod() { return Mod; }
+    constexpr uint32_t val() const { return reduce(v); }
+
+    constexpr MontgomeryModInt &operator+=(const MontgomeryModInt &o)
+    {
+        v += o.v;
+        if (v >= Mod)
+            v -= Mod;
+        return *this;
+    }
+    constexpr MontgomeryModInt &operator-=(const MontgomeryModInt &o)
+    {
+        v += (v < o.v) ? Mod - o.v : -o.v;
+        return *this;
+    }
+    constexpr MontgomeryModInt &operator*=(const MontgomeryModInt &o)
+    {
+        v = reduce(static_cast<uint64_t>(v) * o.v);
+        return *this;
+    }
+    MontgomeryModInt &operator/=(const MontgomeryModInt &o) { return *this *= o.inv(); }
+
+    MontgomeryModInt pow(ll exp) const
+    {
+        ASSERT(exp >= 0, "MontgomeryModInt::pow: Exponent must be non-negative.");
+        MontgomeryModInt res(1), base = *this;
+        for (; exp > 0; exp >>= 1, base *= base)
+            if (exp & 1)
+                res *= base;
+        return res;
+    }
+    MontgomeryModInt inv() const { return MontgomeryModInt(ModularOps<Mod>::inv(val())); }
+
+    friend constexpr MontgomeryModInt operator+(MontgomeryModInt a, const MontgomeryModInt &b) { return a += b; }
+    friend constexpr MontgomeryModInt operator-(MontgomeryModInt a, const MontgomeryModInt &b) { return a -= b; }
+    friend constexpr MontgomeryModInt operator*(MontgomeryModInt a, const MontgomeryModInt &b) { return a *= b; }
+    friend MontgomeryModInt operator/(MontgomeryModInt a, const MontgomeryModInt &b) { return a /= b; }
+    constexpr MontgomeryModInt operator-() const { return MontgomeryModInt() - *this; }
+    friend constexpr bool operator==(const MontgomeryModInt &a, const MontgomeryModInt &b) { return a.v == b.v; }
+    friend constexpr bool operator!=(const MontgomeryModInt &a, const MontgomeryModInt &b) { return a.v != b.v; }
+    friend ostream &operator<<(ostream &out, const MontgomeryModInt &a) { return out << a.val(); }
+};
+
+template <uint32_t Mod>
+struct BarrettModInt
+{
+    static_assert(Mod >= 1 && Mod < (1u << 31), "BarrettModInt needs a modulus in [1, 2^31).");
+
+    static constexpr uint64_t IM = ~0ULL / Mod + 1; // ceil(2^64 / Mod)
+
+    uint32_t v = 0; // Plain residue in [0, Mod)
+
+    static constexpr uint32_t reduce(uint64_t z)
+    { // z mod Mod, for z < Mod^2
+        uint64_t x = static_cast<uint64_t>((static_cast<unsigned __int128>(z) * IM) >> 64);
+        uint64_t y = x * Mod;
+        return static_cast<uint32_t>(z - y + (z < y ? Mod : 0));
+    }
+
+    constexpr BarrettModInt() = default;
+    constexpr BarrettModInt(ll x)
+    {
+        x %= static_cast<ll>(Mod);
+        v = static_cast<uint32_t>(x < 0 ? x + Mod : x);
+    }
+
+    static constexpr uint32_t mod() { return Mod; }
+    constexpr uint32_t val() const { return v; }
+
+    constexpr BarrettModInt &operator+=(const BarrettModInt &o)
+    {
+        v += o.v;
+        if (v >= Mod)
+            v -= Mod;
+        return *this;
+    }
+    constexpr BarrettModInt &operator-=(const BarrettModInt &o)
+    {
+        v += (v < o.v) ? Mod - o.v : -o.v;
+        return *this;
+    }
+    constexpr BarrettModInt &operator*=(const BarrettModInt &o)
+    {
+        v = reduce(static_cast<uint64_t>(v) * o.v);
+        return *this;
+    }
+    BarrettModInt &operator/=(const BarrettModInt &o) { return *this *= o.inv(); }
+
+    BarrettModInt pow(ll exp) const
+    {
+        ASSERT(exp >= 0, "BarrettModInt::pow: Exponent must be non-negative.");
+        BarrettModInt res(1), base = *this;
+        for (; exp > 0; exp >>= 1, base *= base)
+            if (exp & 1)
+                res *= base;
+        return res;
+    }
+    BarrettModInt inv() const { return BarrettModInt(ModularOps<Mod>::inv(v)); }
+
+    friend constexpr BarrettModInt operator+(BarrettModInt a, const BarrettModInt &b) { return a += b; }
+    friend constexpr BarrettModInt operator-(BarrettModInt a, const BarrettModInt &b) { return a -= b; }
+    friend constexpr BarrettModInt operator*(BarrettModInt a, const BarrettModInt &b) { return a *= b; }
+    friend BarrettModInt operator/(BarrettModInt a, const BarrettModInt &b) { return a /= b; }
+    constexpr BarrettModInt operator-() const { return BarrettModInt() - *this; }
+    friend constexpr bool operator==(const BarrettModInt &a, const BarrettModInt &b) { return a.v == b.v; }
+    friend constexpr bool operator!=(const BarrettModInt &a, const BarrettModInt &b) { return a.v != b.v; }
+    friend ostream &operator<<(ostream &out, const BarrettModInt &a) { return out << a.val(); }
+};
+
+template <ll Mod>
+using ModInt = conditional_t<Mod % 2 == 1, MontgomeryModInt<static_cast<uint32_t>(Mod)>, BarrettModInt<static_cast<uint32_t>(Mod)>>;
+using FastMint = ModInt<MOD_CONST>;
+using FastMint1 = ModInt<MOD1_CONST>;
+
 // ──────────────── FAST INPUT/OUTPUT ────────────────────
 #define FASTINOUT                     \
     std::ios::sync_with_stdio(false); \
@@ -228,8 +408,13 @@ using Mint1 = ModularOps<MOD1_CONST>;
 #define eb emplace_back
 #define fi first
 #define se second
+#ifndef NO_FAST_IO
+#define YES print("YES")
+#define NO print("NO")
+#else
 #define YES cout << "YES" << NL
 #define NO cout << "NO" << NL
+#endif
 #define UNIQUE(v) sort(all(v)), v.erase(unique(all(v)), v.end())
 #define forV(v) for (auto &e : (v))
 #define forM(m) for (auto &[key, value] : (m))
@@ -279,57 +464,58 @@ void minimise(T_ref &target, const T_vals &...vals)
 
 // ───────────────── DATA STRUCTURES ────────────────────
 // Disjoint Set Union (DSU) / Union-Find
+// One int per element: parent_or_size[x] is the parent of x, or -(set size) when x is a root.
+// find() is iterative with path halving, so there is no recursion depth to worry about.
 struct DSU
 {
-    vi parent;
-    vi set_size;
+    vi parent_or_size;
     int _num_sets;
 
-    DSU(int n = 0) : parent(n), set_size(n, 1), _num_sets(n)
-    {
-        iota(all(parent), 0);
-    }
+    DSU(int n = 0) : parent_or_size(n, -1), _num_sets(n) {}
 
-    // Find the representative of the set containing x (with path compression)
+    // Find the representative of the set containing x (path halving)
     int find(int x)
     {
-        ASSERT(x >= 0 && x < sz(parent), "DSU::find: Index out of bounds.");
-        if (parent[x] == x)
-            return x;
-        return parent[x] = find(parent[x]);
+        ASSERT(x >= 0 && x < sz(parent_or_size), "DSU::find: Index out of bounds.");
+        while (parent_or_size[x] >= 0)
+        {
+            int p = parent_or_size[x];
+            if (parent_or_size[p] >= 0)
+                parent_or_size[x] = parent_or_size[p]; // Point x at its grandparent
+            x = parent_or_size[x];
+        }
+        return x;
     }
 
     // Unite the sets containing x and y (union by size)
     // Returns true if x and y were in different sets, false otherwise.
     bool unite(int x, int y)
     {
-        ASSERT(x >= 0 && x < sz(parent) && y >= 0 && y < sz(parent), "DSU::unite: Index out of bounds.");
+        ASSERT(x >= 0 && x < sz(parent_or_size) && y >= 0 && y < sz(parent_or_size), "DSU::unite: Index out of bounds.");
         int rootX = find(x);
         int rootY = find(y);
-        if (rootX != rootY)
-        {
-            if (set_size[rootX] < set_size[rootY])
-                swap(rootX, rootY);
-            parent[rootY] = rootX;
-            set_size[rootX] += set_size[rootY];
-            _num_sets--;
-            return true;
-        }
-        return false;
+        if (rootX == rootY)
+            return false;
+        if (parent_or_size[rootX] > parent_or_size[rootY]) // Sizes are stored negated
+            swap(rootX, rootY);
+        parent_or_size[rootX] += parent_or_size[rootY];
+        parent_or_size[rootY] = rootX;
+        _num_sets--;
+        return true;
     }
 
     // Check if x and y are in the same set
     bool connected(int x, int y)
     {
-        ASSERT(x >= 0 && x < sz(parent) && y >= 0 && y < sz(parent), "DSU::connected: Index out of bounds.");
+        ASSERT(x >= 0 && x < sz(parent_or_size) && y >= 0 && y < sz(parent_or_size), "DSU::connected: Index out of bounds.");
         return find(x) == find(y);
     }
 
     // Get the size of the set containing x
     int size(int x)
     {
-        ASSERT(x >= 0 && x < sz(parent), "DSU::size: Index out of bounds.");
-        return set_size[find(x)];
+        ASSERT(x >= 0 && x < sz(parent_or_size), "DSU::size: Index out of bounds.");
+        return -parent_or_size[find(x)];
     }
 
     // Get the number of disjoint sets
@@ -341,9 +527,7 @@ struct DSU
     // Reset the DSU to n disjoint sets.
     void reset(int n)
     {
-        parent.assign(n, 0);
-        iota(all(parent), 0);
-        set_size.assign(n, 1);
+        parent_or_size.assign(n, -1);
         _num_sets = n;
     }
 
@@ -351,10 +535,269 @@ struct DSU
     // Useful if the number of elements is not known at construction.
     void add_element()
     {
-        parent.pb(sz(parent));
-        set_size.pb(1);
+        parent_or_size.pb(-1);
+        _num_sets++;
+    }
+};
+
+// DSU with rollback: union by size without path compression (O(log n) find), and an undo stack.
+// snapshot() marks the current state and rollback(mark) undoes every successful unite made since,
+// which is what offline dynamic connectivity and divide-and-conquer over time need.
+struct RollbackDSU
+{
+    vi parent_or_size;         // Same encoding as DSU
+    vector<pii> history;       // (attached root, its previous parent_or_size) per successful unite
+    int _num_sets;
+
+    RollbackDSU(int n = 0) : parent_or_size(n, -1), _num_sets(n) {}
+
+    int find(int x) const
+    {
+        ASSERT(x >= 0 && x < sz(parent_or_size), "RollbackDSU::find: Index out of bounds.");
+        while (parent_or_size[x] >= 0)
+            x = parent_or_size[x];
+        return x;
+    }
+
+    bool unite(int x, int y)
+    {
+        ASSERT(x >= 0 && x < sz(parent_or_size) && y >= 0 && y < sz(parent_or_size), "RollbackDSU::unite: Index out of bounds.");
+        int rootX = find(x);
+        int rootY = find(y);
+        if (rootX == rootY)
+            return false;
+        if (parent_or_size[rootX] > parent_or_size[rootY])
+            swap(rootX, rootY);
+        history.pb(rootY, parent_or_size[rootY]);
+        parent_or_size[rootX] += parent_or_size[rootY];
+        parent_or_size[rootY] = rootX;
+        _num_sets--;
+        return true;
+    }
+
+    bool connected(int x, int y) const { return find(x) == find(y); }
+    int size(int x) const { return -parent_or_size[find(x)]; }
+    int num_sets() const { return _num_sets; }
+
+    int snapshot() const { return sz(history); }
+
+    // Undo the most recent successful unite
+    void undo()
+    {
+        ASSERT(!history.empty(), "RollbackDSU::undo: Nothing to undo.");
+        auto [child, old_value] = history.back();
+        history.pop_back();
+        int root = parent_or_size[child];
+        parent_or_size[root] -= old_value;
+        parent_or_size[child] = old_value;
         _num_sets++;
     }
+
+    // Undo every unite made after snapshot() returned `mark`
+    void rollback(int mark)
+    {
+        ASSERT(mark >= 0 && mark <= sz(history), "RollbackDSU::rollback: Invalid snapshot.");
+        while (sz(history) > mark)
+            undo();
+    }
+};
+
+// Offline LCA (Tarjan) for a batch of queries, answered in input order in O((n + q) alpha(n)).
+// The tree is given by a preorder `order` (subtrees contiguous, as LCA::order / HLD::pos produce) and
+// `parent` (parent of the root is the root itself); the DFS is replayed from them, so nothing recurses.
+// A query is answered when its second endpoint is entered: the DSU set of the first endpoint has been
+// merged up to the deepest open ancestor, which is the LCA.
+inline vi tarjan_offline_lca(const vi &order, const vi &parent, const vector<pii> &queries)
+{
+    const int n = sz(parent), q = sz(queries);
+    vi ans(q, -1), q_start(n + 1, 0), q_list(2 * q);
+    forV(queries)
+    {
+        ASSERT(e.fi >= 0 && e.fi < n && e.se >= 0 && e.se < n, "tarjan_offline_lca: Node index out of bounds.");
+        q_start[e.fi + 1]++;
+        q_start[e.se + 1]++;
+    }
+    f(v, 0, n) q_start[v + 1] += q_start[v];
+    vi fill_pos(q_start.begin(), q_start.end() - 1);
+    f(i, 0, q)
+    {
+        q_list[fill_pos[queries[i].fi]++] = i;
+        q_list[fill_pos[queries[i].se]++] = i;
+    }
+
+    DSU dsu(n);
+    vi anc(n);
+    vector<char> entered(n, 0);
+    vi stk;
+    stk.reserve(n);
+    forV(order)
+    {
+        const int x = e;
+        while (!stk.empty() && stk.back() != parent[x])
+        { // Close the finished subtree and hang it under its parent
+            int w = stk.back();
+            stk.pop_back();
+            dsu.unite(w, parent[w]);
+            anc[dsu.find(w)] = parent[w];
+        }
+        anc[x] = x;
+        entered[x] = 1;
+        f(k, q_start[x], q_start[x + 1])
+        {
+            const int i = q_list[k];
+            const int y = queries[i].fi ^ queries[i].se ^ x; // The other endpoint
+            if (entered[y] && ans[i] == -1)
+                ans[i] = anc[dsu.find(y)];
+        }
+        stk.pb(x);
+    }
+    return ans;
+}
+
+// Offline dynamic connectivity: record edge insertions, deletions and queries, then solve() them all
+// in O((n + q) log q log n). Each edge's lifetime becomes an interval over the query timeline, stored
+// in a segment tree over queries; a DFS over that tree unites the edges of each node in a RollbackDSU
+// and rolls them back on the way out. Queries mirror DSU::connected / DSU::num_sets.
+struct OfflineDynamicConnectivity
+{
+    enum OpType
+    {
+        ADD_EDGE,
+        REMOVE_EDGE,
+        CONNECTED,
+        NUM_SETS
+    };
+    struct Op
+    {
+        OpType type;
+        int u, v;
+    };
+
+    int n;
+    vector<Op> ops;
+    int num_queries = 0;
+
+    OfflineDynamicConnectivity(int n_val = 0) : n(n_val) {}
+
+    void add_edge(int u, int v)
+    {
+        ASSERT(u >= 0 && u < n && v >= 0 && v < n, "OfflineDynamicConnectivity::add_edge: Node index out of bounds.");
+        ops.pb(Op{ADD_EDGE, min(u, v), max(u, v)});
+    }
+
+    // Removes one copy of a previously added edge
+    void remove_edge(int u, int v)
+    {
+        ASSERT(u >= 0 && u < n && v >= 0 && v < n, "OfflineDynamicConnectivity::remove_edge: Node index out of bounds.");
+        ops.pb(Op{REMOVE_EDGE, min(u, v), max(u, v)});
+    }
+
+    // Each query returns its index into the vector solve() produces
+    int query_connected(int u, int v)
+    {
+        ASSERT(u >= 0 && u < n && v >= 0 && v < n, "OfflineDynamicConnectivity::query_connected: Node index out of bounds.");
+        ops.pb(Op{CONNECTED, u, v});
+        return num_queries++;
+    }
+    int query_num_sets()
+    {
+        ops.pb(Op{NUM_SETS, 0, 0});
+        return num_queries++;
+    }
+
+    // Answers in query order: 1/0 for connected, the number of components for num_sets
+    vi solve()
+    {
+        const int q = num_queries;
+        vi answers(q, 0);
+        if (q == 0)
+            return answers;
+
+        // Edge lifetimes as half-open ranges of query indices
+        vector<pair<int, pii>> lifetimes; // (first query alive, (last query alive + 1, edge index))
+        vector<pii> edges;
+        map<pii, vi> open; // Edge -> query counters at which each live copy was added
+        int seen_queries = 0;
+        forV(ops)
+        {
+            if (e.type == ADD_EDGE)
+                open[{e.u, e.v}].pb(seen_queries);
+            else if (e.type == REMOVE_EDGE)
+            {
+                auto it = open.find({e.u, e.v});
+                ASSERT(it != open.end() && !it->se.empty(), "OfflineDynamicConnectivity: Removing an edge that is not present.");
+                int added = it->se.back();
+                it->se.pop_back();
+                if (added < seen_queries)
+                {
+                    lifetimes.pb(added, pii(seen_queries, sz(edges)));
+                    edges.pb(e.u, e.v);
+                }
+            }
+            else
+                seen_queries++;
+        }
+        forM(open)
+        { // Copies never removed live until the end
+            for (int added : value)
+            {
+                if (added < q)
+                {
+                    lifetimes.pb(added, pii(q, sz(edges)));
+                    edges.pb(key);
+                }
+            }
+        }
+
+        // Segment tree over [0, q): node edge lists in CSR form
+        int size = 1;
+        while (size < q)
+            size <<= 1;
+        vector<pii> placements; // (node, edge)
+        for (auto &[l0, rest] : lifetimes)
+        {
+            int l = l0 + size, r = rest.fi + size;
+            for (; l < r; l >>= 1, r >>= 1)
+            {
+                if (l & 1)
+                    placements.pb(l++, rest.se);
+                if (r & 1)
+                    placements.pb(--r, rest.se);
+            }
+        }
+        vi start(2 * size + 1, 0), node_edges(sz(placements));
+        forV(placements) start[e.fi + 1]++;
+        f(i, 0, 2 * size) start[i + 1] += start[i];
+        vi fill_pos(start.begin(), start.end() - 1);
+        forV(placements) node_edges[fill_pos[e.fi]++] = e.se;
+
+        vi query_ops; // Query index -> op index
+        f(i, 0, sz(ops)) if (ops[i].type == CONNECTED || ops[i].type == NUM_SETS) query_ops.pb(i);
+
+        RollbackDSU dsu(n);
+        auto dfs = [&](auto &&self, int node) -> void
+        {
+            const int mark = dsu.snapshot();
+            f(k, start[node], start[node + 1]) dsu.unite(edges[node_edges[k]].fi, edges[node_edges[k]].se);
+            if (node >= size)
+            {
+                const int qi = node - size;
+                const Op &op = ops[query_ops[qi]];
+                answers[qi] = (op.type == CONNECTED) ? dsu.connected(op.u, op.v) : dsu.num_sets();
+            }
+            else
+            {
+                const int span = size >> __lg(node), first = (node << __lg(span)) - size; // Leftmost query under node
+                if (first < q)
+                    self(self, 2 * node);
+                if (first + span / 2 < q)
+                    self(self, 2 * node + 1);
+            }
+            dsu.rollback(mark);
+        };
+        dfs(dfs, 1);
+        return answers;
+    }
 };
 
 // Segment Tree with Lazy Propagation
@@ -371,7 +814,7 @@ struct DSU
 template <typename T_val = ll, typename T_lazy = ll>
 struct SegTreeLazy
 {
-    int n;                 // Size of the original array, leaves of the tree are at [n, 2n-1]
+    int n;                 // Size of the original array; recursive node indices stay below 4n
     vector<T_val> t;       // Segment tree values
     vector<T_lazy> lazy;   // Lazy propagation array
     T_val neutral_val;     // Neutral element for query merge operation
@@ -403,9 +846,9 @@ struct SegTreeLazy
     {
         if (n > 0)
         {
-            t.assign(2 * n, default_val);
-            lazy.assign(2 * n, neutral_lazy);
-            range_len.assign(2 * n, 0);
+            t.assign(4 * n, default_val);
+            lazy.assign(4 * n, neutral_lazy);
+            range_len.assign(4 * n, 0);
             _build_range_len(1, 0, n - 1);
         }
         else
@@ -420,9 +863,9 @@ struct SegTreeLazy
         : n(sz(arr)), neutral_val(neutral_v), neutral_lazy(neutral_l)
     { // Used sz
         ASSERT(n > 0, "Cannot build SegTreeLazy from an empty array.");
-        t.assign(2 * n, neutral_val);
-        lazy.assign(2 * n, neutral_lazy);
-        range_len.assign(2 * n, 0);
+        t.assign(4 * n, neutral_val);
+        lazy.assign(4 * n, neutral_lazy);
+        range_len.assign(4 * n, 0);
         _build_range_len(1, 0, n - 1);
         _build_from_array(arr, 1, 0, n - 1);
     }
@@ -524,9 +967,9 @@ struct SegTreeLazy
         n = new_n;
         if (n > 0)
         {
-            t.assign(2 * n, default_val);
-            lazy.assign(2 * n, neutral_lazy);
-            range_len.assign(2 * n, 0);
+            t.assign(4 * n, default_val);
+            lazy.assign(4 * n, neutral_lazy);
+            range_len.assign(4 * n, 0);
             _build_range_len(1, 0, n - 1);
         }
         else
@@ -538,186 +981,1441 @@ struct SegTreeLazy
     }
 };
 
-// Fenwick Tree (Binary Indexed Tree - BIT)
-// Default: Prefix Sum Query, Point Update (add value)
-// To customize T (data type) if needed (e.g. for non-integer sums)
-// Operations are 1-indexed internally for easier BIT logic,
-// but public interface can be 0-indexed for consistency with other structures.
-template <typename T = ll>
-struct FenwickTree
+// ── Bottom-up lazy segment tree with policy types ──
+// LazySegTree<Monoid, Action> stores a power-of-two layout (leaves at [size, 2 size)) and never recurses.
+// Monoid: T, id(), op(a, b), and `scales` (true when a value grows with segment length, e.g. sums).
+// Action: F, id(), compose(f, g) (f applied after g) and apply(f, x, len) for a node covering len leaves.
+// Ranges are 0-indexed and inclusive, as in SegTreeLazy. Ready-made combinations are aliased below.
+template <typename V = ll>
+struct SumMonoid
 {
-    int n;
-    vector<T> bit; // Stores the BIT
+    using T = V;
+    static constexpr bool scales = true;
+    static T id() { return T(0); }
+    static T op(const T &a, const T &b) { return a + b; }
+};
 
-    FenwickTree(int n_val = 0) : n(n_val)
+template <typename V = ll>
+struct MinMonoid
+{
+    using T = V;
+    static constexpr bool scales = false;
+    static T id() { return numeric_limits<V>::max(); }
+    static T op(const T &a, const T &b) { return min(a, b); }
+};
+
+template <typename V = ll>
+struct MaxMonoid
+{
+    using T = V;
+    static constexpr bool scales = false;
+    static T id() { return numeric_limits<V>::lowest(); }
+    static T op(const T &a, const T &b) { return max(a, b); }
+};
+
+// x -> x + f
+template <typename M>
+struct AddAction
+{
+    using T = typename M::T;
+    using F = T;
+    static F id() { return F(0); }
+    static F compose(const F &f, const F &g) { return f + g; }
+    static T apply(const F &f, const T &x, int len)
     {
-        if (n > 0)
-        {
-            bit.assign(n + 1, 0); // 1-indexed, so size n+1
-        }
+        if constexpr (M::scales)
+            return x + f * T(len);
         else
-        {
-            bit.clear();
-        }
+            return x + f;
     }
+};
 
-    FenwickTree(const vector<T> &arr) : n(sz(arr))
-    { // Used sz
-        ASSERT(n > 0, "Cannot build Fenwick Tree from an empty array.");
-        bit.assign(n + 1, 0);
-        f(i, 0, n)
-        {                      // Used f macro
-            update(i, arr[i]); // Use 0-indexed public update
-        }
+// x -> v; an F built from a value (implicitly) assigns it, F() is the identity
+template <typename M>
+struct AssignAction
+{
+    using T = typename M::T;
+    struct F
+    {
+        T val{};
+        bool set = false;
+        F() = default;
+        F(T v) : val(v), set(true) {}
+    };
+    static F id() { return F(); }
+    static F compose(const F &f, const F &g) { return f.set ? f : g; }
+    static T apply(const F &f, const T &x, int len)
+    {
+        if (!f.set)
+            return x;
+        if constexpr (M::scales)
+            return f.val * T(len);
+        else
+            return f.val;
     }
+};
 
-    // Add 'delta' to element at 0-indexed position 'idx'
-    void update(int idx, T delta)
+// x -> a * x + b, with F = {a, b}; works with ModInt values for modular range-affine problems
+template <typename M>
+struct AffineAction
+{
+    using T = typename M::T;
+    using F = pair<T, T>;
+    static F id() { return {T(1), T(0)}; }
+    static F compose(const F &f, const F &g) { return {f.fi * g.fi, f.fi * g.se + f.se}; }
+    static T apply(const F &f, const T &x, int len)
     {
-        ASSERT(idx >= 0 && idx < n, "FenwickTree::update: Index out of bounds.");
-        for (++idx; idx <= n; idx += idx & -idx)
-        { // Convert to 1-indexed for BIT logic
-            bit[idx] += delta;
-        }
+        if constexpr (M::scales)
+            return f.fi * x + f.se * T(len);
+        else
+            return f.fi * x + f.se;
     }
+};
 
-    // Query sum from index 0 to 'idx' (inclusive, 0-indexed)
-    T query(int idx)
+template <typename Monoid, typename Action>
+struct LazySegTree
+{
+    using T = typename Monoid::T;
+    using F = typename Action::F;
+
+    int n, size, log;
+    vector<T> d;
+    vector<F> lz;
+
+    LazySegTree(int n_val = 0, T default_val = Monoid::id()) : LazySegTree(vector<T>(n_val, default_val)) {}
+
+    LazySegTree(const vector<T> &arr) : n(sz(arr)), size(1), log(0)
     {
-        ASSERT(idx >= 0 && idx < n, "FenwickTree::query: Index out of bounds for prefix sum.");
-        T sum = 0;
-        for (++idx; idx > 0; idx -= idx & -idx)
-        { // Convert to 1-indexed for BIT logic
-            sum += bit[idx];
-        }
-        return sum;
+        while (size < n)
+            size <<= 1, log++;
+        d.assign(2 * size, Monoid::id());
+        lz.assign(size, Action::id());
+        copy(all(arr), d.begin() + size);
+        rf(k, size, 1) _pull(k);
     }
 
-    // Query sum of range [l, r] (inclusive, 0-indexed)
-    T query_range(int l, int r)
+    void _pull(int k) { d[k] = Monoid::op(d[2 * k], d[2 * k + 1]); }
+
+    void _all_apply(int k, const F &act)
     {
-        ASSERT(l >= 0 && l <= r && r < n, "FenwickTree::query_range: Invalid range.");
-        if (l == 0)
-            return query(r);
-        return query(r) - query(l - 1);
+        d[k] = Action::apply(act, d[k], size >> __lg(k));
+        if (k < size)
+            lz[k] = Action::compose(act, lz[k]);
     }
 
-    void reset(int new_n)
+    void _push(int k)
     {
-        n = new_n;
-        if (n > 0)
-        {
-            bit.assign(n + 1, 0);
-        }
-        else
+        _all_apply(2 * k, lz[k]);
+        _all_apply(2 * k + 1, lz[k]);
+        lz[k] = Action::id();
+    }
+
+    // Push every pending tag on the paths above the half-open leaf range [l, r)
+    void _push_bounds(int l, int r)
+    {
+        for (int i = log; i >= 1; i--)
         {
-            bit.clear();
+            if (((l >> i) << i) != l)
+                _push(l >> i);
+            if (((r >> i) << i) != r)
+                _push((r - 1) >> i);
         }
     }
-};
-
-// ───────────────── GRAPH ALGORITHMS ───────────────────
-
-// Dijkstra's Algorithm for Shortest Paths
-// Graph represented as an adjacency list: vector<vector<pair<int, ll>>> adj
-// adj[u] = vector of pairs {v, weight} for edges from u to v
-// Returns a vector of shortest distances from source `s` to all other nodes.
-// Distances are ll, INF if not reachable.
 
-inline vector<ll> dijkstra(int s, int n, const vector<vector<pii>> &adj)
-{
-    vector<ll> dist(n, INF);
-    dist[s] = 0;
-    pqg<pll> pq; // Min-priority queue: {distance, node_index}
-    pq.emplace(0, s);
+    void set(int p, const T &x)
+    {
+        ASSERT(p >= 0 && p < n, "LazySegTree::set: Index out of bounds.");
+        p += size;
+        for (int i = log; i >= 1; i--)
+            _push(p >> i);
+        d[p] = x;
+        for (int i = 1; i <= log; i++)
+            _pull(p >> i);
+    }
 
-    while (!pq.empty())
+    T get(int p)
     {
-        auto [d, u] = pq.top();
-        pq.pop();
+        ASSERT(p >= 0 && p < n, "LazySegTree::get: Index out of bounds.");
+        p += size;
+        for (int i = log; i >= 1; i--)
+            _push(p >> i);
+        return d[p];
+    }
 
-        if (d > dist[u])
-        { // Already found a shorter path
-            continue;
+    // Fold of [qL, qR]
+    T query(int qL, int qR)
+    {
+        ASSERT(qL >= 0 && qL <= qR && qR < n, "LazySegTree::query: Invalid range.");
+        int l = qL + size, r = qR + 1 + size;
+        _push_bounds(l, r);
+        T sml = Monoid::id(), smr = Monoid::id();
+        while (l < r)
+        {
+            if (l & 1)
+                sml = Monoid::op(sml, d[l++]);
+            if (r & 1)
+                smr = Monoid::op(d[--r], smr);
+            l >>= 1;
+            r >>= 1;
         }
+        return Monoid::op(sml, smr);
+    }
 
-        forV(adj[u])
-        { // Used forV macro, and edge.fi, edge.se implicitly use fi, se
-            int v = e.fi;
-            ll weight = e.se;
-            if (dist[u] + weight < dist[v])
-            {
-                dist[v] = dist[u] + weight;
-                pq.emplace(dist[v], v);
+    T all_query() const { return d[1]; }
+
+    // Apply `act` to every element of [qL, qR]
+    void update(int qL, int qR, const F &act)
+    {
+        ASSERT(qL >= 0 && qL <= qR && qR < n, "LazySegTree::update: Invalid range.");
+        int l = qL + size, r = qR + 1 + size;
+        _push_bounds(l, r);
+        for (int a = l, b = r; a < b; a >>= 1, b >>= 1)
+        {
+            if (a & 1)
+                _all_apply(a++, act);
+            if (b & 1)
+                _all_apply(--b, act);
+        }
+        f(i, 1, log + 1)
+        {
+            if (((l >> i) << i) != l)
+                _pull(l >> i);
+            if (((r >> i) << i) != r)
+                _pull((r - 1) >> i);
+        }
+    }
+
+    void update_point(int p, const F &act) { update(p, p, act); }
+
+    // First index r >= qL at which pred(fold of [qL, r]) fails, or n if it never does. O(log n).
+    // pred must hold for Monoid::id() and be monotone (once false, false for every longer range),
+    // e.g. max_right(0, [&](ll s) { return s <= k; }) is the first index where the prefix sum exceeds k.
+    template <typename Pred>
+    int max_right(int qL, Pred pred)
+    {
+        ASSERT(qL >= 0 && qL <= n, "LazySegTree::max_right: Index out of bounds.");
+        ASSERT(pred(Monoid::id()), "LazySegTree::max_right: pred(id) must hold.");
+        if (qL == n)
+            return n;
+        int l = qL + size;
+        for (int i = log; i >= 1; i--)
+            _push(l >> i);
+        T sm = Monoid::id();
+        do
+        {
+            while (l % 2 == 0)
+                l >>= 1;
+            if (!pred(Monoid::op(sm, d[l])))
+            { // The answer is inside node l: descend
+                while (l < size)
+                {
+                    _push(l);
+                    l = 2 * l;
+                    if (pred(Monoid::op(sm, d[l])))
+                        sm = Monoid::op(sm, d[l++]);
+                }
+                return l - size;
+            }
+            sm = Monoid::op(sm, d[l++]);
+        } while ((l & -l) != l);
+        return n;
+    }
+
+    // Smallest l <= qR + 1 such that pred(fold of [l, qR]) holds (qR + 1 means the empty range). O(log n).
+    // Same requirements on pred as max_right; qR may be -1.
+    template <typename Pred>
+    int min_left(int qR, Pred pred)
+    {
+        ASSERT(qR >= -1 && qR < n, "LazySegTree::min_left: Index out of bounds.");
+        ASSERT(pred(Monoid::id()), "LazySegTree::min_left: pred(id) must hold.");
+        if (qR == -1)
+            return 0;
+        int r = qR + 1 + size;
+        for (int i = log; i >= 1; i--)
+            _push((r - 1) >> i);
+        T sm = Monoid::id();
+        do
+        {
+            r--;
+            while (r > 1 && (r % 2))
+                r >>= 1;
+            if (!pred(Monoid::op(d[r], sm)))
+            {
+                while (r < size)
+                {
+                    _push(r);
+                    r = 2 * r + 1;
+                    if (pred(Monoid::op(d[r], sm)))
+                        sm = Monoid::op(d[r--], sm);
+                }
+                return r + 1 - size;
+            }
+            sm = Monoid::op(d[r], sm);
+        } while ((r & -r) != r);
+        return 0;
+    }
+};
+
+template <typename T = ll>
+using SegTreeAddSum = LazySegTree<SumMonoid<T>, AddAction<SumMonoid<T>>>;
+template <typename T = ll>
+using SegTreeAddMin = LazySegTree<MinMonoid<T>, AddAction<MinMonoid<T>>>;
+template <typename T = ll>
+using SegTreeAddMax = LazySegTree<MaxMonoid<T>, AddAction<MaxMonoid<T>>>;
+template <typename T = ll>
+using SegTreeAssignSum = LazySegTree<SumMonoid<T>, AssignAction<SumMonoid<T>>>;
+template <typename T = ll>
+using SegTreeAssignMin = LazySegTree<MinMonoid<T>, AssignAction<MinMonoid<T>>>;
+template <typename T = ll>
+using SegTreeAssignMax = LazySegTree<MaxMonoid<T>, AssignAction<MaxMonoid<T>>>;
+template <typename T = ll>
+using SegTreeAffineSum = LazySegTree<SumMonoid<T>, AffineAction<SumMonoid<T>>>;
+
+// Segment Tree Beats (Ji's driver tree): range chmin / chmax / add with sum, min and max queries
+// in amortized O((n + q) log^2 n). Nodes keep the largest and smallest values, their counts and the
+// strict second extremes, so a chmin only recurses when it lands between max1 and max2.
+// Ranges are 0-indexed and inclusive; recursion depth is O(log n).
+struct SegTreeBeats
+{
+    static constexpr ll NONE_MAX = LLONG_MIN, NONE_MIN = LLONG_MAX; // "No second extreme" markers
+
+    struct Node
+    {
+        ll sum, max1, max2, min1, min2, lazy_add;
+        int max_cnt, min_cnt, len;
+    };
+
+    int n;
+    vector<Node> t;
+
+    SegTreeBeats(const vll &arr = {}) : n(sz(arr))
+    {
+        if (n > 0)
+        {
+            t.assign(4 * n, Node{});
+            _build(arr, 1, 0, n - 1);
+        }
+    }
+    SegTreeBeats(int n_val, ll default_val) : SegTreeBeats(vll(n_val, default_val)) {}
+
+    void _pull(int k)
+    {
+        Node &x = t[k];
+        const Node &a = t[2 * k], &b = t[2 * k + 1];
+        x.sum = a.sum + b.sum;
+        if (a.max1 == b.max1)
+            x.max1 = a.max1, x.max_cnt = a.max_cnt + b.max_cnt, x.max2 = max(a.max2, b.max2);
+        else if (a.max1 > b.max1)
+            x.max1 = a.max1, x.max_cnt = a.max_cnt, x.max2 = max(a.max2, b.max1);
+        else
+            x.max1 = b.max1, x.max_cnt = b.max_cnt, x.max2 = max(a.max1, b.max2);
+        if (a.min1 == b.min1)
+            x.min1 = a.min1, x.min_cnt = a.min_cnt + b.min_cnt, x.min2 = min(a.min2, b.min2);
+        else if (a.min1 < b.min1)
+            x.min1 = a.min1, x.min_cnt = a.min_cnt, x.min2 = min(a.min2, b.min1);
+        else
+            x.min1 = b.min1, x.min_cnt = b.min_cnt, x.min2 = min(a.min1, b.min2);
+    }
+
+    void _build(const vll &arr, int k, int l, int r)
+    {
+        t[k].len = r - l + 1;
+        if (l == r)
+        {
+            t[k] = Node{arr[l], arr[l], NONE_MAX, arr[l], NONE_MIN, 0, 1, 1, 1};
+            return;
+        }
+        int m = (l + r) / 2;
+        _build(arr, 2 * k, l, m);
+        _build(arr, 2 * k + 1, m + 1, r);
+        _pull(k);
+    }
+
+    void _apply_add(int k, ll x)
+    {
+        Node &v = t[k];
+        v.sum += x * v.len;
+        v.max1 += x;
+        v.min1 += x;
+        if (v.max2 != NONE_MAX)
+            v.max2 += x;
+        if (v.min2 != NONE_MIN)
+            v.min2 += x;
+        v.lazy_add += x;
+    }
+
+    // Lowers the maximum to x; requires max2 < x < max1
+    void _apply_chmin(int k, ll x)
+    {
+        Node &v = t[k];
+        v.sum += (x - v.max1) * v.max_cnt;
+        if (v.min1 == v.max1)
+            v.min1 = x;
+        else if (v.min2 == v.max1)
+            v.min2 = x;
+        v.max1 = x;
+    }
+
+    // Raises the minimum to x; requires min1 < x < min2
+    void _apply_chmax(int k, ll x)
+    {
+        Node &v = t[k];
+        v.sum += (x - v.min1) * v.min_cnt;
+        if (v.max1 == v.min1)
+            v.max1 = x;
+        else if (v.max2 == v.min1)
+            v.max2 = x;
+        v.min1 = x;
+    }
+
+    void _push(int k)
+    {
+        for (int c : {2 * k, 2 * k + 1})
+        {
+            if (t[k].lazy_add != 0)
+                _apply_add(c, t[k].lazy_add);
+            if (t[c].max1 > t[k].max1)
+                _apply_chmin(c, t[k].max1);
+            if (t[c].min1 < t[k].min1)
+                _apply_chmax(c, t[k].min1);
+        }
+        t[k].lazy_add = 0;
+    }
+
+    void _chmin(int k, int l, int r, int qL, int qR, ll x)
+    {
+        if (r < qL || qR < l || t[k].max1 <= x)
+            return;
+        if (qL <= l && r <= qR && t[k].max2 < x)
+        {
+            _apply_chmin(k, x);
+            return;
+        }
+        _push(k);
+        int m = (l + r) / 2;
+        _chmin(2 * k, l, m, qL, qR, x);
+        _chmin(2 * k + 1, m + 1, r, qL, qR, x);
+        _pull(k);
+    }
+
+    void _chmax(int k, int l, int r, int qL, int qR, ll x)
+    {
+        if (r < qL || qR < l || t[k].min1 >= x)
+            return;
+        if (qL <= l && r <= qR && t[k].min2 > x)
+        {
+            _apply_chmax(k, x);
+            return;
+        }
+        _push(k);
+        int m = (l + r) / 2;
+        _chmax(2 * k, l, m, qL, qR, x);
+        _chmax(2 * k + 1, m + 1, r, qL, qR, x);
+        _pull(k);
+    }
+
+    void _add(int k, int l, int r, int qL, int qR, ll x)
+    {
+        if (r < qL || qR < l)
+            return;
+        if (qL <= l && r <= qR)
+        {
+            _apply_add(k, x);
+            return;
+        }
+        _push(k);
+        int m = (l + r) / 2;
+        _add(2 * k, l, m, qL, qR, x);
+        _add(2 * k + 1, m + 1, r, qL, qR, x);
+        _pull(k);
+    }
+
+    // Folds [qL, qR] with `take(node)` for fully covered nodes and `merge` to combine
+    template <typename Take, typename Merge>
+    ll _query(int k, int l, int r, int qL, int qR, ll neutral, Take take, Merge merge)
+    {
+        if (r < qL || qR < l)
+            return neutral;
+        if (qL <= l && r <= qR)
+            return take(t[k]);
+        _push(k);
+        int m = (l + r) / 2;
+        return merge(_query(2 * k, l, m, qL, qR, neutral, take, merge), _query(2 * k + 1, m + 1, r, qL, qR, neutral, take, merge));
+    }
+
+    void chmin(int qL, int qR, ll x) // a[i] = min(a[i], x)
+    {
+        ASSERT(qL >= 0 && qL <= qR && qR < n, "SegTreeBeats::chmin: Invalid range.");
+        _chmin(1, 0, n - 1, qL, qR, x);
+    }
+    void chmax(int qL, int qR, ll x) // a[i] = max(a[i], x)
+    {
+        ASSERT(qL >= 0 && qL <= qR && qR < n, "SegTreeBeats::chmax: Invalid range.");
+        _chmax(1, 0, n - 1, qL, qR, x);
+    }
+    void add(int qL, int qR, ll x) // a[i] += x
+    {
+        ASSERT(qL >= 0 && qL <= qR && qR < n, "SegTreeBeats::add: Invalid range.");
+        _add(1, 0, n - 1, qL, qR, x);
+    }
+    ll query_sum(int qL, int qR)
+    {
+        ASSERT(qL >= 0 && qL <= qR && qR < n, "SegTreeBeats::query_sum: Invalid range.");
+        return _query(1, 0, n - 1, qL, qR, 0, [](const Node &v) { return v.sum; }, [](ll a, ll b) { return a + b; });
+    }
+    ll query_max(int qL, int qR)
+    {
+        ASSERT(qL >= 0 && qL <= qR && qR < n, "SegTreeBeats::query_max: Invalid range.");
+        return _query(1, 0, n - 1, qL, qR, NONE_MAX, [](const Node &v) { return v.max1; }, [](ll a, ll b) { return max(a, b); });
+    }
+    ll query_min(int qL, int qR)
+    {
+        ASSERT(qL >= 0 && qL <= qR && qR < n, "SegTreeBeats::query_min: Invalid range.");
+        return _query(1, 0, n - 1, qL, qR, NONE_MIN, [](const Node &v) { return v.min1; }, [](ll a, ll b) { return min(a, b); });
+    }
+};
+
+// Persistent segment tree (point add, range sum) with path copying.
+// Nodes live in one arena and refer to children by index; node 0 is the shared all-zero subtree, so an
+// empty version costs nothing and every update allocates exactly one node per level.
+// Every operation takes a version root and updates return the new root, e.g.
+//     roots.pb(pst.update(roots.back(), pos, delta));   // version t + 1
+// After reserve(nodes_needed(n, updates)) no update allocates. Ranges are 0-indexed and inclusive.
+template <typename T = ll>
+struct PersistentSegTree
+{
+    struct Node
+    {
+        T val;
+        int left, right;
+    };
+
+    int n;
+    vector<Node> pool;
+
+    PersistentSegTree(int n_val = 0, int expected_updates = 0) : n(n_val)
+    {
+        reserve(nodes_needed(n, expected_updates));
+        pool.pb(Node{T(0), 0, 0}); // Null node
+    }
+
+    // Arena size for a built array of n elements followed by `updates` point updates
+    static size_t nodes_needed(int n, int updates)
+    {
+        int levels = 1;
+        while ((1 << (levels - 1)) < n)
+            levels++;
+        return 1 + 2 * static_cast<size_t>(n) + static_cast<size_t>(updates) * levels;
+    }
+
+    void reserve(size_t nodes) { pool.reserve(nodes); }
+
+    // Root of the all-zero version
+    int empty_root() const { return 0; }
+
+    int _new_node(T val, int left, int right)
+    {
+        pool.pb(Node{val, left, right});
+        return sz(pool) - 1;
+    }
+
+    int _build(const vector<T> &arr, int l, int r)
+    {
+        if (l == r)
+            return _new_node(arr[l], 0, 0);
+        int m = (l + r) / 2;
+        int left = _build(arr, l, m), right = _build(arr, m + 1, r);
+        return _new_node(pool[left].val + pool[right].val, left, right);
+    }
+
+    // Root of a version holding arr (|arr| must be n)
+    int build(const vector<T> &arr)
+    {
+        ASSERT(sz(arr) == n, "PersistentSegTree::build: Array size must equal n.");
+        return n == 0 ? 0 : _build(arr, 0, n - 1);
+    }
+
+    // New version with a[pos] += delta; the path is copied top-down, no recursion
+    int update(int root, int pos, T delta)
+    {
+        ASSERT(pos >= 0 && pos < n, "PersistentSegTree::update: Index out of bounds.");
+        const int new_root = _new_node(pool[root].val + delta, pool[root].left, pool[root].right);
+        int cur = new_root, l = 0, r = n - 1;
+        while (l < r)
+        {
+            int m = (l + r) / 2;
+            const bool go_left = pos <= m;
+            const int old_child = go_left ? pool[cur].left : pool[cur].right;
+            const int child = _new_node(pool[old_child].val + delta, pool[old_child].left, pool[old_child].right);
+            (go_left ? pool[cur].left : pool[cur].right) = child;
+            cur = child;
+            if (go_left)
+                r = m;
+            else
+                l = m + 1;
+        }
+        return new_root;
+    }
+
+    // New version with a[pos] = val
+    int set(int root, int pos, T val)
+    {
+        return update(root, pos, val - query(root, pos, pos));
+    }
+
+    T _query(int node, int l, int r, int qL, int qR) const
+    {
+        if (node == 0 || r < qL || qR < l)
+            return T(0);
+        if (qL <= l && r <= qR)
+            return pool[node].val;
+        int m = (l + r) / 2;
+        return _query(pool[node].left, l, m, qL, qR) + _query(pool[node].right, m + 1, r, qL, qR);
+    }
+
+    // Sum of [qL, qR] in the given version
+    T query(int root, int qL, int qR) const
+    {
+        ASSERT(qL >= 0 && qL <= qR && qR < n, "PersistentSegTree::query: Invalid range.");
+        return _query(root, 0, n - 1, qL, qR);
+    }
+
+    // Smallest p with sum_{i <= p} (after[i] - before[i]) >= k, for k >= 1 (difference must reach k).
+    // With a version per array prefix over a count-per-value tree, this is the k-th smallest value in a range:
+    //     kth(roots[l], roots[r + 1], k)
+    int kth(int root_before, int root_after, T k) const
+    {
+        ASSERT(k >= 1 && k <= pool[root_after].val - pool[root_before].val, "PersistentSegTree::kth: k out of range.");
+        int a = root_before, b = root_after, l = 0, r = n - 1;
+        while (l < r)
+        {
+            int m = (l + r) / 2;
+            T left_count = pool[pool[b].left].val - pool[pool[a].left].val;
+            if (k <= left_count)
+            {
+                a = pool[a].left;
+                b = pool[b].left;
+                r = m;
+            }
+            else
+            {
+                k -= left_count;
+                a = pool[a].right;
+                b = pool[b].right;
+                l = m + 1;
+            }
+        }
+        return l;
+    }
+};
+
+// Fenwick Tree (Binary Indexed Tree - BIT)
+// Default: Prefix Sum Query, Point Update (add value)
+// To customize T (data type) if needed (e.g. for non-integer sums)
+// Operations are 1-indexed internally for easier BIT logic,
+// but public interface can be 0-indexed for consistency with other structures.
+template <typename T = ll>
+struct FenwickTree
+{
+    int n;
+    vector<T> bit; // Stores the BIT
+
+    FenwickTree(int n_val = 0) : n(n_val)
+    {
+        if (n > 0)
+        {
+            bit.assign(n + 1, 0); // 1-indexed, so size n+1
+        }
+        else
+        {
+            bit.clear();
+        }
+    }
+
+    // O(n) build: each node pushes its partial sum into its parent once
+    FenwickTree(const vector<T> &arr) : n(sz(arr))
+    { // Used sz
+        ASSERT(n > 0, "Cannot build Fenwick Tree from an empty array.");
+        bit.assign(n + 1, 0);
+        copy(all(arr), bit.begin() + 1);
+        cf(i, 1, n)
+        {
+            int parent = i + (i & -i);
+            if (parent <= n)
+                bit[parent] += bit[i];
+        }
+    }
+
+    // Add 'delta' to element at 0-indexed position 'idx'
+    void update(int idx, T delta)
+    {
+        ASSERT(idx >= 0 && idx < n, "FenwickTree::update: Index out of bounds.");
+        for (++idx; idx <= n; idx += idx & -idx)
+        { // Convert to 1-indexed for BIT logic
+            bit[idx] += delta;
+        }
+    }
+
+    // Query sum from index 0 to 'idx' (inclusive, 0-indexed)
+    T query(int idx)
+    {
+        ASSERT(idx >= 0 && idx < n, "FenwickTree::query: Index out of bounds for prefix sum.");
+        T sum = 0;
+        for (++idx; idx > 0; idx -= idx & -idx)
+        { // Convert to 1-indexed for BIT logic
+            sum += bit[idx];
+        }
+        return sum;
+    }
+
+    // Query sum of range [l, r] (inclusive, 0-indexed)
+    T query_range(int l, int r)
+    {
+        ASSERT(l >= 0 && l <= r && r < n, "FenwickTree::query_range: Invalid range.");
+        if (l == 0)
+            return query(r);
+        return query(r) - query(l - 1);
+    }
+
+    // Smallest 0-indexed idx with query(idx) >= k, or n if the total is below k.
+    // O(log n) descent; requires all elements to be non-negative.
+    int lower_bound(T k) const
+    {
+        if (k <= 0)
+            return 0;
+        int pos = 0;
+        for (int step = n > 0 ? 1 << __lg(n) : 0; step > 0; step >>= 1)
+        {
+            if (pos + step <= n && bit[pos + step] < k)
+            {
+                pos += step;
+                k -= bit[pos];
+            }
+        }
+        return pos; // The first pos elements sum to less than k, so 0-indexed pos is the answer
+    }
+
+    void reset(int new_n)
+    {
+        n = new_n;
+        if (n > 0)
+        {
+            bit.assign(n + 1, 0);
+        }
+        else
+        {
+            bit.clear();
+        }
+    }
+};
+
+// Range-add / range-sum Fenwick tree (two BITs over the difference array):
+// prefix(i) = (i + 1) * sum d[0..i] - sum d[j] * j, where d is the difference array.
+template <typename T = ll>
+struct RangeFenwickTree
+{
+    int n;
+    FenwickTree<T> d, dj; // d[j] and d[j] * j
+
+    RangeFenwickTree(int n_val = 0) : n(n_val), d(n_val), dj(n_val) {}
+
+    // O(n) build from initial values
+    RangeFenwickTree(const vector<T> &arr) : n(sz(arr)), d(_diff(arr, false)), dj(_diff(arr, true)) {}
+
+    static vector<T> _diff(const vector<T> &arr, bool weighted)
+    {
+        vector<T> res(sz(arr));
+        f(i, 0, sz(arr))
+        {
+            res[i] = arr[i] - (i > 0 ? arr[i - 1] : T(0));
+            if (weighted)
+                res[i] *= static_cast<T>(i);
+        }
+        return res;
+    }
+
+    // Add delta to every element of [l, r] (inclusive, 0-indexed)
+    void update(int l, int r, T delta)
+    {
+        ASSERT(l >= 0 && l <= r && r < n, "RangeFenwickTree::update: Invalid range.");
+        d.update(l, delta);
+        dj.update(l, delta * static_cast<T>(l));
+        if (r + 1 < n)
+        {
+            d.update(r + 1, -delta);
+            dj.update(r + 1, -delta * static_cast<T>(r + 1));
+        }
+    }
+
+    // Sum of [0, idx]
+    T query(int idx)
+    {
+        ASSERT(idx >= 0 && idx < n, "RangeFenwickTree::query: Index out of bounds.");
+        return d.query(idx) * static_cast<T>(idx + 1) - dj.query(idx);
+    }
+
+    // Sum of [l, r]
+    T query_range(int l, int r)
+    {
+        ASSERT(l >= 0 && l <= r && r < n, "RangeFenwickTree::query_range: Invalid range.");
+        return l == 0 ? query(r) : query(r) - query(l - 1);
+    }
+};
+
+// 2D Fenwick tree (point add, rectangle sum) over one flat (n + 1) x (m + 1) array
+template <typename T = ll>
+struct FenwickTree2D
+{
+    int n, m;
+    vector<T> bit; // bit[x * (m + 1) + y], 1-indexed in both dimensions
+
+    FenwickTree2D(int n_val = 0, int m_val = 0) : n(n_val), m(m_val), bit(static_cast<size_t>(n_val + 1) * (m_val + 1), 0) {}
+
+    // Add delta at 0-indexed cell (x, y)
+    void update(int x, int y, T delta)
+    {
+        ASSERT(x >= 0 && x < n && y >= 0 && y < m, "FenwickTree2D::update: Index out of bounds.");
+        for (int i = x + 1; i <= n; i += i & -i)
+        {
+            T *row = bit.data() + static_cast<size_t>(i) * (m + 1);
+            for (int j = y + 1; j <= m; j += j & -j)
+                row[j] += delta;
+        }
+    }
+
+    // Sum of the rectangle [0, x] x [0, y]
+    T query(int x, int y) const
+    {
+        ASSERT(x >= -1 && x < n && y >= -1 && y < m, "FenwickTree2D::query: Index out of bounds.");
+        T sum = 0;
+        for (int i = x + 1; i > 0; i -= i & -i)
+        {
+            const T *row = bit.data() + static_cast<size_t>(i) * (m + 1);
+            for (int j = y + 1; j > 0; j -= j & -j)
+                sum += row[j];
+        }
+        return sum;
+    }
+
+    // Sum of the rectangle [x1, x2] x [y1, y2] (inclusive)
+    T query_rect(int x1, int y1, int x2, int y2) const
+    {
+        ASSERT(x1 >= 0 && x1 <= x2 && x2 < n && y1 >= 0 && y1 <= y2 && y2 < m, "FenwickTree2D::query_rect: Invalid rectangle.");
+        return query(x2, y2) - query(x1 - 1, y2) - query(x2, y1 - 1) + query(x1 - 1, y1 - 1);
+    }
+};
+
+// ───────────────── GRAPH ALGORITHMS ───────────────────
+
+// Compressed sparse row (CSR) graph: the out-edges of u occupy [offsets[u], offsets[u + 1]) in the
+// packed `targets` (and `weights`, empty for unweighted graphs). One build, three allocations, and
+// traversals stream through contiguous memory. Undirected edges are stored once per direction.
+template <typename W = int>
+struct CSRGraph
+{
+    int n;
+    vi offsets;
+    vi targets;
+    vector<W> weights;
+
+    CSRGraph(int n_val = 0) : n(n_val), offsets(n_val + 1, 0) {}
+
+    // From an edge list {u, v}
+    static CSRGraph from_edges(int n, const vector<pii> &edges, bool directed = false)
+    {
+        return _build(n, edges, nullptr, directed);
+    }
+
+    // From a weighted edge list {u, v, w}
+    static CSRGraph from_weighted_edges(int n, const vector<tuple<int, int, W>> &edges, bool directed = false)
+    {
+        vector<pii> ends(sz(edges));
+        vector<W> ws(sz(edges));
+        f(i, 0, sz(edges))
+        {
+            ends[i] = {get<0>(edges[i]), get<1>(edges[i])};
+            ws[i] = get<2>(edges[i]);
+        }
+        return _build(n, ends, &ws, directed);
+    }
+
+    // From an adjacency list of {v, w} pairs (the format dijkstra / bfs01 take), keeping edge order
+    static CSRGraph from_adjacency(const vector<vector<pair<int, W>>> &adj)
+    {
+        CSRGraph g(sz(adj));
+        f(u, 0, g.n) g.offsets[u + 1] = g.offsets[u] + sz(adj[u]);
+        g.targets.reserve(g.offsets[g.n]);
+        g.weights.reserve(g.offsets[g.n]);
+        forV(adj) for (auto &[v, w] : e)
+        {
+            g.targets.pb(v);
+            g.weights.pb(w);
+        }
+        return g;
+    }
+
+    // Counting sort by source: O(n + m)
+    static CSRGraph _build(int n, const vector<pii> &edges, const vector<W> *ws, bool directed)
+    {
+        CSRGraph g(n);
+        forV(edges)
+        {
+            ASSERT(e.fi >= 0 && e.fi < n && e.se >= 0 && e.se < n, "CSRGraph: Node index out of bounds.");
+            g.offsets[e.fi + 1]++;
+            if (!directed)
+                g.offsets[e.se + 1]++;
+        }
+        f(u, 0, n) g.offsets[u + 1] += g.offsets[u];
+        g.targets.resize(g.offsets[n]);
+        if (ws)
+            g.weights.resize(g.offsets[n]);
+        vi fill_pos(g.offsets.begin(), g.offsets.end() - 1);
+        f(i, 0, sz(edges))
+        {
+            auto [u, v] = edges[i];
+            int k = fill_pos[u]++;
+            g.targets[k] = v;
+            if (ws)
+                g.weights[k] = (*ws)[i];
+            if (!directed)
+            {
+                k = fill_pos[v]++;
+                g.targets[k] = u;
+                if (ws)
+                    g.weights[k] = (*ws)[i];
+            }
+        }
+        return g;
+    }
+
+    int num_edges() const { return sz(targets); }
+    int degree(int u) const { return offsets[u + 1] - offsets[u]; }
+    span<const int> neighbors(int u) const { return {targets.data() + offsets[u], targets.data() + offsets[u + 1]}; }
+};
+
+// Uniform neighbor access so traversals can be written once for vector<vi> and CSRGraph
+inline const vi &adjacent(const vector<vi> &adj, int u) { return adj[u]; }
+template <typename W>
+span<const int> adjacent(const CSRGraph<W> &g, int u) { return g.neighbors(u); }
+
+// ── Traversal layer (iterative, works on vector<vi> or CSRGraph) ──
+
+// Unweighted BFS distances from s; -1 marks unreachable nodes
+template <typename Graph>
+vi bfs_distances(const Graph &g, int s, int n)
+{
+    vi dist(n, -1), q(n);
+    int head = 0, tail = 0;
+    dist[s] = 0;
+    q[tail++] = s;
+    while (head < tail)
+    {
+        int u = q[head++];
+        for (int v : adjacent(g, u))
+        {
+            if (dist[v] == -1)
+            {
+                dist[v] = dist[u] + 1;
+                q[tail++] = v;
             }
         }
     }
     return dist;
 }
 
-// 0-1 BFS for Shortest Paths (edge weights are 0 or 1)
-// Graph represented as an adjacency list: vector<vector<pair<int, int>>> adj
-// adj[u] = vector of pairs {v, weight} where weight is 0 or 1.
-// Returns a vector of shortest distances (ll) from source `s`.
-inline vector<ll> bfs01(int s, int n, const vector<vector<pii>> &adj)
+// DFS preorder from root (explicit stack); parent[root] = root, unreached nodes keep parent -1
+template <typename Graph>
+vi dfs_preorder(const Graph &g, int root, int n, vi *parent_out = nullptr)
+{
+    vi order, parent(n, -1), stk = {root};
+    order.reserve(n);
+    parent[root] = root;
+    while (!stk.empty())
+    {
+        int u = stk.back();
+        stk.pop_back();
+        order.pb(u);
+        for (int v : adjacent(g, u))
+        {
+            if (parent[v] == -1)
+            {
+                parent[v] = u;
+                stk.pb(v);
+            }
+        }
+    }
+    if (parent_out)
+        *parent_out = move(parent);
+    return order;
+}
+
+// Component id (0, 1, ... in order of the smallest node) of every node
+template <typename Graph>
+vi connected_components(const Graph &g, int n)
+{
+    vi comp(n, -1), stk;
+    int count = 0;
+    f(s, 0, n)
+    {
+        if (comp[s] != -1)
+            continue;
+        comp[s] = count;
+        stk.pb(s);
+        while (!stk.empty())
+        {
+            int u = stk.back();
+            stk.pop_back();
+            for (int v : adjacent(g, u))
+            {
+                if (comp[v] == -1)
+                {
+                    comp[v] = count;
+                    stk.pb(v);
+                }
+            }
+        }
+        count++;
+    }
+    return comp;
+}
+
+template <typename W>
+vi bfs_distances(const CSRGraph<W> &g, int s) { return bfs_distances(g, s, g.n); }
+template <typename W>
+vi dfs_preorder(const CSRGraph<W> &g, int root, vi *parent_out = nullptr) { return dfs_preorder(g, root, g.n, parent_out); }
+template <typename W>
+vi connected_components(const CSRGraph<W> &g) { return connected_components(g, g.n); }
+
+// ── Priority queues for Dijkstra ──
+// All three share push(v, d) / pop() -> {d, v} / empty() / clear(); clear() keeps capacity so a
+// heap can be reused across searches. Lazy heaps may return stale entries (d > dist[v]).
+
+// Binary heap with lazy deletion: up to E entries, any weights
+struct LazyBinaryHeap
+{
+    vector<pll> data;
+
+    LazyBinaryHeap(int = 0) {}
+    bool empty() const { return data.empty(); }
+    void clear() { data.clear(); }
+    void push(int v, ll d)
+    {
+        data.eb(d, v);
+        push_heap(all(data), greater<pll>());
+    }
+    pll pop()
+    {
+        pop_heap(all(data), greater<pll>());
+        pll top = data.back();
+        data.pop_back();
+        return top;
+    }
+};
+
+// Monotone radix heap: keys must never drop below the last popped key (non-negative Dijkstra).
+// Each entry moves down at most 64 buckets, so pushes are O(1) and pops amortised O(log C).
+struct RadixHeap
+{
+    vector<pll> buckets[65]; // buckets[i]: keys whose highest bit differing from `last` is i - 1
+    ll last = 0;
+    int count = 0;
+
+    RadixHeap(int = 0) {}
+    static int _bucket(ll key, ll last_key) { return key == last_key ? 0 : 64 - __builtin_clzll(static_cast<ull>(key ^ last_key)); }
+    bool empty() const { return count == 0; }
+    void clear()
+    {
+        for (auto &b : buckets)
+            b.clear();
+        last = count = 0;
+    }
+    void push(int v, ll d)
+    {
+        ASSERT(d >= last, "RadixHeap::push: Key below the last popped key.");
+        buckets[_bucket(d, last)].eb(d, v);
+        count++;
+    }
+    pll pop()
+    {
+        if (buckets[0].empty())
+        {
+            int i = 1;
+            while (buckets[i].empty())
+                i++;
+            last = min_element(all(buckets[i]))->fi;
+            forV(buckets[i]) buckets[_bucket(e.fi, last)].pb(e);
+            buckets[i].clear();
+        }
+        pll top = buckets[0].back();
+        buckets[0].pop_back();
+        count--;
+        return top;
+    }
+};
+
+// Indexed D-ary heap with decrease-key: at most n entries, never stale
+template <int D = 4>
+struct IndexedDaryHeap
+{
+    vi heap, pos; // pos[v] is v's slot in heap, -1 if absent
+    vll key;
+
+    IndexedDaryHeap(int n = 0) : pos(n, -1), key(n) {}
+    bool empty() const { return heap.empty(); }
+    void clear()
+    {
+        forV(heap) pos[e] = -1;
+        heap.clear();
+    }
+    void _place(int v, int i)
+    {
+        heap[i] = v;
+        pos[v] = i;
+    }
+    void _sift_up(int i)
+    {
+        int v = heap[i];
+        while (i > 0 && key[heap[(i - 1) / D]] > key[v])
+        {
+            _place(heap[(i - 1) / D], i);
+            i = (i - 1) / D;
+        }
+        _place(v, i);
+    }
+    void _sift_down(int i)
+    {
+        const int m = sz(heap);
+        int v = heap[i];
+        while (true)
+        {
+            int best = -1;
+            const int first = i * D + 1;
+            f(c, first, min(first + D, m))
+            {
+                if (best == -1 || key[heap[c]] < key[heap[best]])
+                    best = c;
+            }
+            if (best == -1 || key[heap[best]] >= key[v])
+                break;
+            _place(heap[best], i);
+            i = best;
+        }
+        _place(v, i);
+    }
+    // Insert v, or lower its key if already present
+    void push(int v, ll d)
+    {
+        key[v] = d;
+        if (pos[v] == -1)
+        {
+            heap.pb(v);
+            pos[v] = sz(heap) - 1;
+        }
+        _sift_up(pos[v]);
+    }
+    pll pop()
+    {
+        int v = heap[0];
+        pos[v] = -1;
+        int back = heap.back();
+        heap.pop_back();
+        if (!heap.empty())
+        {
+            heap[0] = back;
+            _sift_down(0);
+        }
+        return {key[v], v};
+    }
+};
+
+enum DijkstraHeap
+{
+    BINARY_HEAP, // Lazy binary heap, the default
+    RADIX_HEAP,  // Non-negative integer weights; fastest on large sparse graphs
+    DARY_HEAP    // Indexed 4-ary heap with decrease-key; n entries at most
+};
+
+// Calls fn(v, w) for every out-edge of u
+template <typename Fn>
+void for_each_out_edge(const vector<vector<pii>> &adj, int u, Fn &&fn)
+{
+    for (auto [v, w] : adj[u])
+        fn(v, w);
+}
+template <typename W, typename Fn>
+void for_each_out_edge(const CSRGraph<W> &g, int u, Fn &&fn)
+{
+    f(k, g.offsets[u], g.offsets[u + 1]) fn(g.targets[k], g.weights[k]);
+}
+
+// Core loop on caller-owned dist (filled with INF; a vector or span) and heap; stops once `target` is settled.
+template <typename Graph, typename Heap, typename Dist>
+void dijkstra_run(const Graph &g, const vi &sources, int target, Heap &heap, Dist &dist)
+{
+    heap.clear();
+    forV(sources)
+    {
+        dist[e] = 0;
+        heap.push(e, 0);
+    }
+    while (!heap.empty())
+    {
+        auto [d, u] = heap.pop();
+        if (d > dist[u])
+            continue; // Stale entry
+        if (u == target)
+            break;
+        for_each_out_edge(g, u, [&](int v, ll weight)
+        {
+            if (d + weight < dist[v])
+            {
+                dist[v] = d + weight;
+                heap.push(v, dist[v]);
+            }
+        });
+    }
+}
+
+// Multi-source Dijkstra: dist[v] = min over sources of the shortest distance, INF if unreachable.
+// With target != -1 the search stops as soon as target is settled; only dist[target] (and nodes
+// settled before it) are final then.
+template <typename Graph>
+vector<ll> dijkstra_from(const vi &sources, int n, const Graph &g, DijkstraHeap heap = BINARY_HEAP, int target = -1)
 {
     vector<ll> dist(n, INF);
-    dist[s] = 0;
-    deque<int> q_bfs; // Renamed to avoid conflict with `dq` type alias if it were used locally for `std::deque`.
-    q_bfs.emplace_front(s);
+    if (heap == RADIX_HEAP)
+    {
+        RadixHeap h;
+        dijkstra_run(g, sources, target, h, dist);
+    }
+    else if (heap == DARY_HEAP)
+    {
+        IndexedDaryHeap<4> h(n);
+        dijkstra_run(g, sources, target, h, dist);
+    }
+    else
+    {
+        LazyBinaryHeap h;
+        dijkstra_run(g, sources, target, h, dist);
+    }
+    return dist;
+}
+
+// Dijkstra's Algorithm for Shortest Paths
+// Graph represented as an adjacency list: vector<vector<pair<int, int>>> adj
+// adj[u] = vector of pairs {v, weight} for edges from u to v
+// Returns a vector of shortest distances from source `s` to all other nodes.
+// Distances are ll, INF if not reachable.
+inline vector<ll> dijkstra(int s, int n, const vector<vector<pii>> &adj, DijkstraHeap heap = BINARY_HEAP, int target = -1)
+{
+    return dijkstra_from({s}, n, adj, heap, target);
+}
 
+// 0-1 BFS core loop on caller-owned dist (filled with INF) and deque; edge weights must be 0 or 1
+template <typename Graph, typename Dist>
+void bfs01_run(const Graph &g, const vi &sources, deque<int> &q_bfs, Dist &dist)
+{
+    q_bfs.clear();
+    forV(sources)
+    {
+        dist[e] = 0;
+        q_bfs.pb(e);
+    }
     while (!q_bfs.empty())
     {
         int u = q_bfs.front();
         q_bfs.pop_front();
-
-        forV(adj[u])
-        { // Used forV macro, and e.fi, e.se implicitly use fi, se
-            int v = e.fi;
-            int weight = e.se;
+        for_each_out_edge(g, u, [&](int v, ll weight)
+        {
             ASSERT(weight == 0 || weight == 1, "0-1 BFS expects edge weights to be 0 or 1.");
-
             if (dist[u] + weight < dist[v])
             {
                 dist[v] = dist[u] + weight;
                 if (weight == 1)
-                {
                     q_bfs.emplace_back(v);
-                }
                 else
-                { // weight == 0
                     q_bfs.emplace_front(v);
-                }
             }
-        }
+        });
     }
+}
+
+// 0-1 BFS for Shortest Paths (edge weights are 0 or 1)
+// Graph represented as an adjacency list: vector<vector<pair<int, int>>> adj
+// adj[u] = vector of pairs {v, weight} where weight is 0 or 1.
+// Returns a vector of shortest distances (ll) from source `s`.
+inline vector<ll> bfs01(int s, int n, const vector<vector<pii>> &adj)
+{
+    vector<ll> dist(n, INF);
+    deque<int> q_bfs; // Renamed to avoid conflict with `dq` type alias if it were used locally for `std::deque`.
+    bfs01_run(adj, {s}, q_bfs, dist);
+    return dist;
+}
+
+// dijkstra over a weighted CSRGraph (same result as the adjacency-list version)
+template <typename W>
+vector<ll> dijkstra(int s, const CSRGraph<W> &g, DijkstraHeap heap = BINARY_HEAP, int target = -1)
+{
+    return dijkstra_from({s}, g.n, g, heap, target);
+}
+
+// bfs01 over a CSRGraph with 0/1 weights
+template <typename W>
+vector<ll> bfs01(int s, const CSRGraph<W> &g)
+{
+    vector<ll> dist(g.n, INF);
+    deque<int> q_bfs;
+    bfs01_run(g, {s}, q_bfs, dist);
     return dist;
 }
 
-// Lowest Common Ancestor (LCA) using Binary Lifting
-// Assumes tree is 0-indexed. MAX_NODES can be adjusted.
-const int MAX_LCA_NODES = 200005; // Max number of nodes for LCA
-const int MAX_LCA_LG = 20;        // Max log for binary lifting (ceil(log2(MAX_LCA_NODES)))
+// ── Parallel batch searches ──
+
+// Work-sharing pool: `threads` workers (0 = every hardware thread) each run worker(claim); claim()
+// hands out each index of [0, count) exactly once and returns -1 when none are left.
+template <typename Worker>
+void run_parallel(int count, int threads, Worker &&worker)
+{
+    if (threads <= 0)
+        threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    threads = max(1, min(threads, count));
+    atomic<int> next{0};
+    auto claim = [&]() -> int
+    {
+        int i = next.fetch_add(1, memory_order_relaxed);
+        return i < count ? i : -1;
+    };
+    vector<thread> pool;
+    f(t, 1, threads) pool.eb([&] { worker(claim); });
+    worker(claim); // The calling thread is worker 0
+    for (auto &th : pool)
+        th.join();
+}
+
+// One search per source; every worker owns a dist buffer and a queue (make_state()) reused for all
+// its searches. search(dist, state, src) runs on dist already filled with INF.
+template <typename MakeState, typename Search, typename Callback>
+void _batch_search(const vi &sources, int n, int threads, MakeState &&make_state, Search &&search, Callback &&on_result)
+{
+    run_parallel(sz(sources), threads, [&](auto &claim)
+    {
+        vector<ll> dist(n);
+        auto state = make_state();
+        vi src(1);
+        for (int i = claim(); i != -1; i = claim())
+        {
+            src[0] = sources[i];
+            fill(all(dist), INF);
+            search(dist, state, src);
+            on_result(i, static_cast<const vector<ll> &>(dist));
+        }
+    });
+}
+
+// Calls on_result(i, dist) with the distances from sources[i]. Calls come from worker threads
+// concurrently and in no particular order; dist is only valid during the call.
+template <typename Graph, typename Callback>
+void dijkstra_batch(const vi &sources, int n, const Graph &g, Callback &&on_result, DijkstraHeap heap = BINARY_HEAP, int threads = 0)
+{
+    auto search = [&](vector<ll> &dist, auto &h, const vi &src) { dijkstra_run(g, src, -1, h, dist); };
+    if (heap == RADIX_HEAP)
+        _batch_search(sources, n, threads, [] { return RadixHeap(); }, search, on_result);
+    else if (heap == DARY_HEAP)
+        _batch_search(sources, n, threads, [n] { return IndexedDaryHeap<4>(n); }, search, on_result);
+    else
+        _batch_search(sources, n, threads, [] { return LazyBinaryHeap(); }, search, on_result);
+}
+
+template <typename Graph, typename Callback>
+void bfs01_batch(const vi &sources, int n, const Graph &g, Callback &&on_result, int threads = 0)
+{
+    auto search = [&](vector<ll> &dist, deque<int> &q_bfs, const vi &src) { bfs01_run(g, src, q_bfs, dist); };
+    _batch_search(sources, n, threads, [] { return deque<int>(); }, search, on_result);
+}
+
+// Row-major |sources| x n distance matrix: row i is written in place by the worker that ran sources[i]
+template <typename Graph>
+vector<ll> dijkstra_batch_matrix(const vi &sources, int n, const Graph &g, DijkstraHeap heap = BINARY_HEAP, int threads = 0)
+{
+    vector<ll> out(static_cast<size_t>(sz(sources)) * n, INF);
+    auto run = [&](auto make_heap)
+    {
+        run_parallel(sz(sources), threads, [&](auto &claim)
+        {
+            auto h = make_heap();
+            vi src(1);
+            for (int i = claim(); i != -1; i = claim())
+            {
+                src[0] = sources[i];
+                span<ll> row(out.data() + static_cast<size_t>(i) * n, n);
+                dijkstra_run(g, src, -1, h, row);
+            }
+        });
+    };
+    if (heap == RADIX_HEAP)
+        run([] { return RadixHeap(); });
+    else if (heap == DARY_HEAP)
+        run([n] { return IndexedDaryHeap<4>(n); });
+    else
+        run([] { return LazyBinaryHeap(); });
+    return out;
+}
+
+template <typename Graph>
+vector<ll> bfs01_batch_matrix(const vi &sources, int n, const Graph &g, int threads = 0)
+{
+    vector<ll> out(static_cast<size_t>(sz(sources)) * n, INF);
+    run_parallel(sz(sources), threads, [&](auto &claim)
+    {
+        deque<int> q_bfs;
+        vi src(1);
+        for (int i = claim(); i != -1; i = claim())
+        {
+            src[0] = sources[i];
+            span<ll> row(out.data() + static_cast<size_t>(i) * n, n);
+            bfs01_run(g, src, q_bfs, row);
+        }
+    });
+    return out;
+}
+
+// Lowest Common Ancestor (LCA) on a rooted tree, 0-indexed.
+// build() is iterative (no recursion limit on deep trees) and supports two query modes:
+//   - BINARY_LIFTING: level-major jump table of ceil(log2 n) levels, O(log n) get_lca / get_kth_ancestor.
+//   - EULER_TOUR: sparse table over the DFS order (tin of each node's parent), O(1) get_lca;
+//     get_kth_ancestor binary-searches the per-depth DFS order instead of using a jump table.
+const int MAX_LCA_NODES = 200005; // Kept for existing code; LCA sizes its tables from n
+const int MAX_LCA_LG = 20;        // Kept for existing code; LCA uses ceil(log2 n) levels
 
 struct LCA
 {
+    enum Mode
+    {
+        BINARY_LIFTING,
+        EULER_TOUR
+    };
+
     int n_nodes;
     vector<vi> adj;
     vi depth;
-    vector<vi> up; // up[v][j] is the 2^j-th ancestor of v
+    vi parent;
+    int lg = 1; // Levels in the jump / sparse table
+    vi up;      // BINARY_LIFTING: up[j * n_nodes + v] is the 2^j-th ancestor of v
     int timer;
-    vi tin, tout; // For subtree checks, if needed (optional here, focus on LCA/dist)
+    vi tin, tout; // Preorder index of v and the last preorder index inside its subtree
+    vi order;     // order[tin[v]] = v
+    Mode mode = BINARY_LIFTING;
+    vi sparse;                 // EULER_TOUR: sparse[j * sz(order) + t] = min tin of a parent over order[t, t + 2^j)
+    vi level_start, level_tin; // EULER_TOUR: tins of the nodes at depth d are level_tin[level_start[d], level_start[d + 1])
 
-    LCA(int n = 0) : n_nodes(n)
+    LCA(int n = 0) : n_nodes(n), timer(0)
     {
         if (n > 0)
         {
             adj.assign(n, vi());
             depth.assign(n, 0);
-            up.assign(n, vi(MAX_LCA_LG));
             tin.assign(n, 0);
             tout.assign(n, 0);
-            timer = 0;
         }
     }
 
@@ -728,35 +2426,101 @@ struct LCA
         adj[v].pb(u); // Used pb. Corrected: should be adj[v].pb(u)
     }
 
-    void _dfs_lca(int v, int p, int d)
+    // Iterative preorder; subtrees occupy contiguous tin ranges
+    template <typename Graph>
+    void _dfs_order(const Graph &g, int root)
     {
-        depth[v] = d;
-        up[v][0] = p;
-        tin[v] = ++timer;
+        parent.assign(n_nodes, root);
+        depth.assign(n_nodes, 0);
+        order.clear();
+        vi stk = {root};
+        timer = 0;
+        while (!stk.empty())
+        {
+            int v = stk.back();
+            stk.pop_back();
+            tin[v] = timer++;
+            order.pb(v);
+            for (int e : adjacent(g, v))
+            {
+                if (e != parent[v])
+                {
+                    parent[e] = v;
+                    depth[e] = depth[v] + 1;
+                    stk.pb(e);
+                }
+            }
+        }
+        vi sub(n_nodes, 1);
+        rf(t, sz(order), 1) sub[parent[order[t]]] += sub[order[t]];
+        forV(order) tout[e] = tin[e] + sub[e] - 1;
+    }
 
-        f(j, 1, MAX_LCA_LG)
-        { // Used f macro
-            up[v][j] = up[up[v][j - 1]][j - 1];
+    void _build_lifting()
+    {
+        lg = 1;
+        while ((1 << lg) < n_nodes)
+            lg++;
+        up.resize(static_cast<size_t>(lg) * n_nodes);
+        copy(all(parent), up.begin());
+        f(j, 1, lg)
+        {
+            const int *prev = up.data() + (j - 1) * n_nodes;
+            int *cur = up.data() + j * n_nodes;
+            f(v, 0, n_nodes) cur[v] = prev[prev[v]];
         }
+    }
 
-        forV(adj[v])
-        { // Used forV macro
-            if (e != p)
-            {
-                _dfs_lca(e, v, d + 1);
-            }
+    void _build_euler()
+    {
+        const int m = sz(order);
+        lg = __lg(m) + 1;
+        sparse.resize(static_cast<size_t>(lg) * m);
+        f(t, 0, m) sparse[t] = tin[parent[order[t]]];
+        f(j, 1, lg)
+        {
+            const int *prev = sparse.data() + (j - 1) * m;
+            int *cur = sparse.data() + j * m;
+            const int half = 1 << (j - 1);
+            f(t, 0, m - 2 * half + 1) cur[t] = min(prev[t], prev[t + half]);
         }
-        tout[v] = ++timer;
+
+        // Counting sort of the preorder by depth keeps tins ascending within each level
+        int max_depth = 0;
+        forV(order) max_depth = max(max_depth, depth[e]);
+        level_start.assign(max_depth + 2, 0);
+        forV(order) level_start[depth[e] + 1]++;
+        f(d, 0, max_depth + 1) level_start[d + 1] += level_start[d];
+        level_tin.resize(m);
+        vi fill_pos(level_start.begin(), level_start.end() - 1);
+        forV(order) level_tin[fill_pos[depth[e]]++] = tin[e];
     }
 
-    // Call after adding all edges. Root is typically 0.
-    void build(int root = 0)
+    template <typename Graph>
+    void _build(const Graph &g, int root, Mode build_mode)
     {
         if (n_nodes == 0)
             return;
         ASSERT(root >= 0 && root < n_nodes, "LCA::build: Root index out of bounds.");
-        timer = 0;
-        _dfs_lca(root, root, 0); // Parent of root is root itself, depth 0
+        mode = build_mode;
+        _dfs_order(g, root);
+        if (mode == BINARY_LIFTING)
+            _build_lifting();
+        else
+            _build_euler();
+    }
+
+    // Call after adding all edges. Root is typically 0.
+    void build(int root = 0, Mode build_mode = BINARY_LIFTING) { _build(adj, root, build_mode); }
+
+    // Build straight from a tree in CSR form (both directions stored); add_edge is not needed
+    template <typename W>
+    void build(const CSRGraph<W> &g, int root = 0, Mode build_mode = BINARY_LIFTING)
+    {
+        n_nodes = g.n;
+        tin.assign(n_nodes, 0);
+        tout.assign(n_nodes, 0);
+        _build(g, root, build_mode);
     }
 
     // Get k-th ancestor of node u (0-th ancestor is u itself)
@@ -766,12 +2530,16 @@ struct LCA
         if (k < 0 || k > depth[u])
             return -1; // Or handle as error/specific value
 
-        rf(j, MAX_LCA_LG, 0)
-        { // Used rf macro
-            if ((k >> j) & 1)
-            {
-                u = up[u][j];
-            }
+        if (mode == EULER_TOUR)
+        { // The ancestor at depth d is the last node of that depth entered before u
+            const int d = depth[u] - k;
+            auto it = upper_bound(level_tin.begin() + level_start[d], level_tin.begin() + level_start[d + 1], tin[u]);
+            return order[*prev(it)];
+        }
+        for (int j = 0; k > 0; j++, k >>= 1)
+        {
+            if (k & 1)
+                u = up[j * n_nodes + u];
         }
         return u;
     }
@@ -779,23 +2547,37 @@ struct LCA
     int get_lca(int u, int v)
     {
         ASSERT(u >= 0 && u < n_nodes && v >= 0 && v < n_nodes, "LCA::get_lca: Node index out of bounds.");
+        if (u == v)
+            return u;
+        if (mode == EULER_TOUR)
+        { // Parent of the shallowest node in order(tin[u], tin[v]] is the LCA
+            int a = tin[u], b = tin[v];
+            if (a > b)
+                swap(a, b);
+            const int m = sz(order), j = __lg(b - a);
+            return order[min(sparse[j * m + a + 1], sparse[j * m + b - (1 << j) + 1])];
+        }
         if (depth[u] < depth[v])
             swap(u, v);
-
         u = get_kth_ancestor(u, depth[u] - depth[v]);
-
         if (u == v)
             return u;
-
-        rf(j, MAX_LCA_LG, 0)
-        { // Used rf macro
-            if (up[u][j] != up[v][j])
+        rf(j, __lg(depth[u]) + 1, 0)
+        { // Only levels below the current depth can differ
+            const int *row = up.data() + j * n_nodes;
+            if (row[u] != row[v])
             {
-                u = up[u][j];
-                v = up[v][j];
+                u = row[u];
+                v = row[v];
             }
         }
-        return up[u][0];
+        return parent[u];
+    }
+
+    // LCAs of all (u, v) pairs in input order via tarjan_offline_lca; beats per-query binary lifting on large batches
+    vi get_lca_batch(const vector<pii> &queries)
+    {
+        return tarjan_offline_lca(order, parent, queries);
     }
 
     int get_dist(int u, int v)
@@ -933,6 +2715,9 @@ struct StringHashing
         B1 = (b1 == 0) ? generate_random_base(MIN_BASE, M1 - 1) : b1;
         B2 = (b2 == 0) ? generate_random_base(MIN_BASE, M2 - 1) : b2;
 
+        B1 %= M1; // Barrett reduction below needs residues
+        B2 %= M2;
+
         // Ensure B1 and B2 are different, especially if M1 or M2 could be the same (though we use different M1, M2 here)
         // or if one was user-provided and the other generated.
         while (B1 == B2)
@@ -946,17 +2731,19 @@ struct StringHashing
         p2.resize(n + 1, 1);
         // inv_p1.resize(n + 1, 1); inv_p2.resize(n + 1, 1); // If using division method
 
-        ModularOps<MOD_CONST> Ops1;  // Use MOD_CONST for M1 related ops
-        ModularOps<MOD1_CONST> Ops2; // Use MOD1_CONST for M2 related ops
+        // Barrett reduction keeps division out of the loop: h * B + c < M^2 reduces in one step.
+        using R1 = BarrettModInt<MOD_CONST>;
+        using R2 = BarrettModInt<MOD1_CONST>;
 
         f(i, 0, n)
         { // Used f macro
-            p1[i + 1] = Ops1.mul(p1[i], B1);
-            p2[i + 1] = Ops2.mul(p2[i], B2);
+            p1[i + 1] = R1::reduce(static_cast<uint64_t>(p1[i]) * B1);
+            p2[i + 1] = R2::reduce(static_cast<uint64_t>(p2[i]) * B2);
             // For ASCII, s[i] is char. For 0-indexed 'a'-'z', use (s[i] - 'a' + 1)
             // Assuming s[i] gives small integer values (e.g., chars, or 1-indexed values)
-            h1[i + 1] = Ops1.add(Ops1.mul(h1[i], B1), (s[i] - ' ' + 1)); // Shift ' ' to 1 for safety, or use s[i] if it's already int > 0
-            h2[i + 1] = Ops2.add(Ops2.mul(h2[i], B2), (s[i] - ' ' + 1));
+            const ll c = s[i] - ' ' + 1; // Shift ' ' to 1 for safety, or use s[i] if it's already int > 0
+            h1[i + 1] = R1::reduce(static_cast<uint64_t>(h1[i]) * B1 + (c < 0 ? c + M1 : c));
+            h2[i + 1] = R2::reduce(static_cast<uint64_t>(h2[i]) * B2 + (c < 0 ? c + M2 : c));
         }
 
         // If using division method for substring hash, precompute inverse powers:
@@ -977,11 +2764,12 @@ struct StringHashing
         if (n == 0)
             return {0, 0};
 
-        ModularOps<MOD_CONST> Ops1;
-        ModularOps<MOD1_CONST> Ops2;
-
-        ll sub_hash1 = Ops1.sub(h1[r + 1], Ops1.mul(h1[l], p1[r - l + 1]));
-        ll sub_hash2 = Ops2.sub(h2[r + 1], Ops2.mul(h2[l], p2[r - l + 1]));
+        ll sub_hash1 = h1[r + 1] - BarrettModInt<MOD_CONST>::reduce(static_cast<uint64_t>(h1[l]) * p1[r - l + 1]);
+        ll sub_hash2 = h2[r + 1] - BarrettModInt<MOD1_CONST>::reduce(static_cast<uint64_t>(h2[l]) * p2[r - l + 1]);
+        if (sub_hash1 < 0)
+            sub_hash1 += M1;
+        if (sub_hash2 < 0)
+            sub_hash2 += M2;
 
         return {sub_hash1, sub_hash2};
     }
@@ -1013,15 +2801,36 @@ inline void precompute_factorials()
     if (MAX_N_COMB == 0)
         return; // Should not happen with current const value but good check
 
-    fact[0] = 1;
-    invFact[0] = 1;
-    ModularOps<Mod> M_ops; // Local ModularOps instance for this function call
-    f(i, 1, MAX_N_COMB)
-    { // Used f macro
-        // Safety check, though fact/invFact should be sized correctly by their definition.
-        ASSERT(i < sz(fact) && i < sz(invFact), "Factorial precomputation index out of bounds.");
-        fact[i] = M_ops.mul(fact[i - 1], i);
-        invFact[i] = M_ops.inv(fact[i]);
+    ASSERT(sz(fact) >= MAX_N_COMB && sz(invFact) >= MAX_N_COMB, "Factorial precomputation index out of bounds.");
+
+    // One modular inverse for the largest invertible factorial, then walk down: invFact[i-1] = invFact[i] * i.
+    // For a prime Mod below MAX_N_COMB, factorials from Mod on are 0 and get invFact 0.
+    const int limit = static_cast<int>(min<ll>(MAX_N_COMB, Mod));
+    fill(invFact.begin() + limit, invFact.begin() + MAX_N_COMB, 0);
+    if constexpr (Mod < (1LL << 31))
+    {
+        using MI = ModInt<Mod>;
+        MI cur = 1;
+        fact[0] = 1;
+        f(i, 1, MAX_N_COMB)
+        { // Used f macro
+            cur *= MI(i);
+            fact[i] = cur.val();
+        }
+        cur = MI(fact[limit - 1]).inv();
+        rf(i, limit, 0)
+        { // Used rf macro
+            invFact[i] = cur.val();
+            cur *= MI(i);
+        }
+    }
+    else
+    {
+        ModularOps<Mod> M_ops; // Local ModularOps instance for this function call
+        fact[0] = 1;
+        f(i, 1, MAX_N_COMB) fact[i] = M_ops.mul(fact[i - 1], i);
+        invFact[limit - 1] = M_ops.inv(fact[limit - 1]);
+        rf(i, limit, 1) invFact[i - 1] = M_ops.mul(invFact[i], i);
     }
 }
 
@@ -1101,6 +2910,39 @@ inline ll nt_power(ll base, ll exp, ll mod)
     return res;
 }
 
+// Square root modulo an odd prime p (Tonelli-Shanks); returns -1 if a is not a quadratic residue.
+inline ll sqrt_mod(ll a, ll p)
+{
+    a = (a % p + p) % p;
+    if (a == 0 || p == 2)
+        return a;
+    if (nt_power(a, (p - 1) / 2, p) != 1)
+        return -1;
+    ll q = p - 1;
+    int s = 0;
+    while (q % 2 == 0)
+    {
+        q /= 2;
+        s++;
+    }
+    ll z = 2;
+    while (nt_power(z, (p - 1) / 2, p) != p - 1)
+        z++;
+    ll c = nt_power(z, q, p), t = nt_power(a, q, p), r = nt_power(a, (q + 1) / 2, p);
+    while (t != 1)
+    {
+        int i = 0;
+        for (ll t2 = t; t2 != 1; t2 = nt_mul(t2, t2, p))
+            i++;
+        ll b = nt_power(c, 1LL << (s - i - 1), p);
+        s = i;
+        c = nt_mul(b, b, p);
+        t = nt_mul(t, c, p);
+        r = nt_mul(r, b, p);
+    }
+    return r;
+}
+
 inline bool check_composite(ll n, ll a, ll d, int s)
 {
     ll x = nt_power(a, d, n);
@@ -1183,276 +3025,1051 @@ struct Sieve
                 {          // e for element in primes
                     break; // p is no longer the smallest prime factor, or we exceed limit
                 }
-                is_prime[i * e] = false;
-                spf[i * e] = e;
+                is_prime[i * e] = false;
+                spf[i * e] = e;
+            }
+        }
+    }
+
+    // Get prime factorization of k
+    // Returns a vector of pairs {prime, exponent}
+    vpll get_prime_factorization(int k)
+    {
+        ASSERT(k > 0 && k <= max_val, "get_prime_factorization input out of sieve range or non-positive.");
+        vpll factors;
+        if (k == 1)
+            return factors; // Or return {{1,1}} depending on convention
+        while (k > 1)
+        {
+            int p = spf[k];
+            int count = 0;
+            while (k % p == 0)
+            {
+                k /= p;
+                count++;
+            }
+            factors.eb(p, count); // Used eb for pair construction
+        }
+        return factors;
+    }
+
+    // Get all distinct prime factors of k
+    vll get_distinct_prime_factors(int k)
+    {
+        ASSERT(k > 0 && k <= max_val, "get_distinct_prime_factors input out of sieve range or non-positive.");
+        vll distinct_factors;
+        if (k == 1)
+            return distinct_factors;
+        while (k > 1)
+        {
+            int p = spf[k];
+            distinct_factors.pb(p); // Used pb
+            while (k % p == 0)
+            {
+                k /= p;
+            }
+        }
+        return distinct_factors;
+    }
+};
+
+#if __cplusplus >= 202002L
+template <std::integral T1, std::integral T2>
+constexpr bool isDivisible(T1 n, T2 divisor)
+{
+    if (divisor == 0)
+    {
+        return false;
+    }
+    return (n % divisor == 0);
+}
+
+template <std::integral T>
+constexpr bool isOdd(T n)
+{
+    return !isDivisible(n, 2);
+}
+#else
+template <typename T1, typename T2>
+constexpr bool isDivisible(T1 n, T2 divisor)
+{
+    if (divisor == 0)
+    {
+        return false;
+    }
+    return (n % divisor == 0);
+}
+
+template <typename T>
+constexpr bool isOdd(T n)
+{
+    return !isDivisible(n, 2);
+}
+#endif
+
+// ──────────────── LINEAR ALGEBRA UTILITIES ───────────────
+
+// Matrix struct for matrix exponentiation and other linear algebra operations.
+// Assumes operations are done under a specific modulus, using Mint by default.
+template <typename T = ll, ll Mod = MOD_CONST> // Allow flexible data type and modulus
+struct Matrix
+{
+    int rows, cols;
+    vector<vector<T>> mat;
+    ModularOps<Mod> M; // Modular operations for the given Modulus
+
+    Matrix(int r = 0, int c = 0, T val = 0) : rows(r), cols(c)
+    {
+        if (r > 0 && c > 0)
+        {
+            mat.assign(r, vector<T>(c, val));
+        }
+    }
+
+    // Constructor for identity matrix
+    static Matrix identity(int n)
+    {
+        Matrix id(n, n);
+        f(i, 0, n)
+        { // Used f macro
+            id.mat[i][i] = 1;
+        }
+        return id;
+    }
+
+    // Matrix multiplication: C = A * B
+    Matrix operator*(const Matrix &other) const
+    {
+        ASSERT(cols == other.rows, "Matrix multiplication: Column count of first matrix must match row count of second matrix.");
+        Matrix result(rows, other.cols);
+        // i-k-j order walks both matrices row by row; products are summed exactly in 128 bits
+        // and each output cell is reduced once, so the inner loop does no division at all.
+        vector<__int128> acc(other.cols);
+        f(i, 0, rows)
+        { // Used f macro
+            fill(acc.begin(), acc.end(), 0);
+            f(k, 0, cols)
+            { // Used f macro
+                const __int128 a_ik = mat[i][k];
+                const vector<T> &row = other.mat[k];
+                f(j, 0, other.cols) acc[j] += a_ik * row[j];
+            }
+            f(j, 0, other.cols) result.mat[i][j] = M.normalize(static_cast<ll>(acc[j] % Mod));
+        }
+        return result;
+    }
+
+    // For debugging or printing the matrix
+    void print_matrix() const
+    {
+        f(i, 0, rows)
+        { // Used f macro
+            f(j, 0, cols)
+            { // Used f macro
+                cout << mat[i][j] << (j == cols - 1 ? "" : " ");
+            }
+            cout << NL;
+        }
+    }
+};
+
+// Matrix exponentiation (binary exponentiation for matrices)
+// Returns base^exp % Mod. Base must be a square matrix.
+template <typename T, ll Mod>
+Matrix<T, Mod> matrix_power(Matrix<T, Mod> base, ll exp)
+{
+    ASSERT(base.rows == base.cols, "Matrix power: Base matrix must be square.");
+    Matrix<T, Mod> result = Matrix<T, Mod>::identity(base.rows);
+    // ModularOps instances M are already members of base and result, initialized by their constructors.
+    // Re-assigning them here (base.M = ..., result.M = ...) is redundant if Matrix constructor correctly initializes M.
+
+    while (exp > 0)
+    {
+        if (exp % 2 == 1)
+            result = result * base;
+        base = base * base;
+        exp /= 2;
+    }
+    return result;
+}
+
+// Residual network shared by the flow algorithms. Edges are recorded as added, then packed into
+// flat per-node arc arrays (CSR) the first time an algorithm runs after edits: the arcs leaving u
+// are [start[u], start[u + 1]), and arc k's reverse is rev[k]. Flows survive repacking.
+struct FlowNetwork
+{
+    int n_nodes;
+    vi edge_from, edge_to; // id-th added edge
+    vll edge_cap, edge_cost;
+    vi start, to, rev, edge_arc; // edge_arc[id]: arc of the id-th added edge (its residual is rev[edge_arc[id]])
+    vll cap, cost;               // Residual capacity and cost of each arc
+    bool _dirty = false;
+
+    FlowNetwork(int n = 0) : n_nodes(n), start(n + 1, 0) {}
+
+    // Adds a directed edge u->v; returns its id
+    int add_edge(int u, int v, ll cap_val, ll cost_val = 0)
+    {
+        ASSERT(u >= 0 && u < n_nodes && v >= 0 && v < n_nodes, "FlowNetwork::add_edge: Node index out of bounds.");
+        ASSERT(cap_val >= 0, "FlowNetwork::add_edge: Capacity must be non-negative.");
+        edge_from.pb(u);
+        edge_to.pb(v);
+        edge_cap.pb(cap_val);
+        edge_cost.pb(cost_val);
+        _dirty = true;
+        return sz(edge_from) - 1;
+    }
+
+    int num_edges() const { return sz(edge_from); }
+    ll flow(int id) const { return _dirty ? _old_flow(id) : cap[rev[edge_arc[id]]]; }
+    ll _old_flow(int id) const { return id < sz(edge_arc) ? cap[rev[edge_arc[id]]] : 0; }
+
+    void build()
+    {
+        if (!_dirty)
+            return;
+        const int m = num_edges();
+        vll flows(m);
+        f(id, 0, m) flows[id] = _old_flow(id);
+        start.assign(n_nodes + 1, 0);
+        f(id, 0, m)
+        {
+            start[edge_from[id] + 1]++;
+            start[edge_to[id] + 1]++;
+        }
+        f(u, 0, n_nodes) start[u + 1] += start[u];
+        to.resize(2 * m), rev.resize(2 * m), cap.resize(2 * m), cost.resize(2 * m), edge_arc.resize(m);
+        vi fill_pos(start.begin(), start.end() - 1);
+        f(id, 0, m)
+        {
+            int a = fill_pos[edge_from[id]]++, b = fill_pos[edge_to[id]]++;
+            to[a] = edge_to[id], rev[a] = b, cap[a] = edge_cap[id] - flows[id], cost[a] = edge_cost[id];
+            to[b] = edge_from[id], rev[b] = a, cap[b] = flows[id], cost[b] = -edge_cost[id];
+            edge_arc[id] = a;
+        }
+        _dirty = false;
+    }
+
+    // Nodes reachable from s in the residual network: after a max flow, the source side of a minimum cut
+    vector<bool> min_cut(int s)
+    {
+        build();
+        vector<bool> seen(n_nodes, false);
+        vi stk = {s};
+        seen[s] = true;
+        while (!stk.empty())
+        {
+            int u = stk.back();
+            stk.pop_back();
+            f(k, start[u], start[u + 1])
+            {
+                if (cap[k] > 0 && !seen[to[k]])
+                {
+                    seen[to[k]] = true;
+                    stk.pb(to[k]);
+                }
+            }
+        }
+        return seen;
+    }
+};
+
+// Max Flow - Dinic's Algorithm
+// Generally faster than Edmonds-Karp for many graph types.
+// Levels are distances to the sink (BFS backwards from t), so the DFS never enters nodes that cannot
+// reach t. The blocking-flow DFS is iterative and, after an augmentation, resumes from the tail of
+// the first saturated arc instead of restarting at the source, so one pass pushes many paths.
+struct DinicMaxFlow
+{
+    FlowNetwork net;
+    vi level; // level[u]: distance from u to the sink in the level graph, -1 if not in it
+    vi ptr;   // Next arc to explore for each node in the current phase
+    vi path;  // Arc stack of the DFS (also the BFS queue)
+
+    DinicMaxFlow(int n = 0) : net(n), level(n), ptr(n) {}
+    DinicMaxFlow(FlowNetwork network) : net(move(network)), level(net.n_nodes), ptr(net.n_nodes) {}
+
+    // Adds a directed edge u->v with capacity cap. Returns its id for flow().
+    int add_edge(int u, int v, ll cap_val)
+    {
+        ASSERT(u >= 0 && u < net.n_nodes && v >= 0 && v < net.n_nodes, "DinicMaxFlow::add_edge: Node index out of bounds.");
+        ASSERT(cap_val >= 0, "DinicMaxFlow::add_edge: Capacity must be non-negative.");
+        return net.add_edge(u, v, cap_val);
+    }
+
+    ll flow(int id) const { return net.flow(id); }        // Flow on the id-th added edge
+    vector<bool> min_cut(int s) { return net.min_cut(s); } // After get_max_flow: source side of a min cut
+
+    // Backward BFS from t over arcs with residual capacity >= delta; true if s gets a level.
+    bool _bfs_dinic(int s, int t, ll delta)
+    {
+        fill(all(level), -1);
+        level[t] = 0;
+        vi &q = path;
+        q.assign(1, t);
+        for (int head = 0; head < sz(q) && level[s] == -1; head++)
+        {
+            int v = q[head];
+            f(k, net.start[v], net.start[v + 1])
+            {
+                int u = net.to[k]; // Arc rev[k] is u -> v
+                if (level[u] < 0 && net.cap[net.rev[k]] >= delta)
+                {
+                    level[u] = level[v] + 1;
+                    q.pb(u);
+                }
+            }
+        }
+        return level[s] != -1; // True if sink t is reachable
+    }
+
+    // Blocking flow of the level graph using only arcs with capacity >= delta, stopping at `limit`.
+    ll _blocking_flow(int s, int t, ll delta, ll limit)
+    {
+        const int *start = net.start.data(), *to = net.to.data(), *rev = net.rev.data();
+        ll *cap = net.cap.data();
+        f(u, 0, net.n_nodes) ptr[u] = start[u];
+        path.clear();
+        ll total = 0;
+        int u = s;
+        while (true)
+        {
+            if (u == t)
+            {
+                ll pushed = limit - total;
+                forV(path) pushed = min(pushed, cap[e]);
+                int keep = -1; // Retreat to the tail of the first arc this push saturates
+                f(k, 0, sz(path))
+                {
+                    cap[path[k]] -= pushed;
+                    cap[rev[path[k]]] += pushed;
+                    if (keep == -1 && cap[path[k]] < delta)
+                        keep = k;
+                }
+                total += pushed;
+                if (total == limit)
+                    break;
+                path.resize(keep);
+                u = path.empty() ? s : to[path.back()];
+                continue;
+            }
+            int &k = ptr[u];
+            while (k < start[u + 1] && (cap[k] < delta || level[to[k]] != level[u] - 1))
+                k++;
+            if (k < start[u + 1])
+            { // Advance
+                path.pb(k);
+                u = to[k];
+            }
+            else
+            { // Dead end: drop u from the level graph and retreat
+                level[u] = -1;
+                if (path.empty())
+                    break;
+                u = to[rev[path.back()]];
+                path.pop_back();
+                ptr[u]++;
+            }
+        }
+        return total;
+    }
+
+    // Maximum s-t flow (at most `limit`), added to any flow already present. With capacity_scaling,
+    // phases only use arcs of residual capacity >= delta for delta = 2^k, ..., 1, which helps when
+    // capacities span many orders of magnitude; plain Dinic is the single phase delta = 1.
+    ll get_max_flow(int s, int t, bool capacity_scaling = false, ll limit = INF)
+    {
+        ASSERT(s >= 0 && s < net.n_nodes && t >= 0 && t < net.n_nodes, "DinicMaxFlow::get_max_flow: Source/sink index out of bounds.");
+        if (s == t)
+            return INF; // Or 0, by convention
+        net.build();
+
+        ll delta = 1;
+        if (capacity_scaling && !net.cap.empty())
+        {
+            ll max_cap = *max_element(all(net.cap));
+            while (delta <= max_cap / 2)
+                delta *= 2;
+        }
+        ll total_flow = 0;
+        for (; delta >= 1 && total_flow < limit; delta /= 2)
+        {
+            while (total_flow < limit && _bfs_dinic(s, t, delta)) // While s can reach t in the level graph
+                total_flow += _blocking_flow(s, t, delta, limit - total_flow);
+        }
+        return total_flow;
+    }
+};
+
+// Min-Cost Flow on the same FlowNetwork storage as DinicMaxFlow.
+//   - SUCCESSIVE_SHORTEST_PATHS: Dijkstra on reduced costs with Johnson potentials (Bellman-Ford
+//     repairs them first when costs are negative), one augmenting path per search. Needs no
+//     negative cycles.
+//   - COST_SCALING: Dinic for the flow value, then Goldberg-Tarjan cost-scaling push-relabel
+//     cancels the remaining cost (handles negative cycles). Best on dense assignment-type graphs.
+// After a run, `net` is the optimal residual network and `potential` a matching dual solution
+// (reduced costs cost[k] + potential[u] - potential[to[k]] >= 0 on every residual arc).
+struct MinCostFlow
+{
+    enum Method
+    {
+        SUCCESSIVE_SHORTEST_PATHS,
+        COST_SCALING
+    };
+
+    FlowNetwork net;
+    vll potential;
+    DijkstraHeap heap = DARY_HEAP; // Priority queue of the SSP searches
+
+    MinCostFlow(int n = 0) : net(n), potential(n, 0) {}
+
+    // Adds a directed edge u->v with capacity cap and per-unit cost. Returns its id for flow().
+    int add_edge(int u, int v, ll cap_val, ll cost_val)
+    {
+        ASSERT(u >= 0 && u < net.n_nodes && v >= 0 && v < net.n_nodes, "MinCostFlow::add_edge: Node index out of bounds.");
+        ASSERT(cap_val >= 0, "MinCostFlow::add_edge: Capacity must be non-negative.");
+        return net.add_edge(u, v, cap_val, cost_val);
+    }
+
+    ll flow(int id) const { return net.flow(id); }        // Flow on the id-th added edge
+    vector<bool> min_cut(int s) { return net.min_cut(s); } // After a max flow: source side of a min cut
+
+    // Total cost of the current flow
+    ll total_cost() const
+    {
+        ll total = 0;
+        f(id, 0, net.num_edges()) total += flow(id) * net.edge_cost[id];
+        return total;
+    }
+
+    // Label-correcting Bellman-Ford from the current potentials until every residual arc has a
+    // non-negative reduced cost (requires no negative cycle in the residual network)
+    void _repair_potential()
+    {
+        const int n = net.n_nodes;
+        vi q(n);
+        iota(all(q), 0);
+        vector<bool> queued(n, true);
+        for (int head = 0; head < sz(q); head++)
+        {
+            int u = q[head];
+            queued[u] = false;
+            f(k, net.start[u], net.start[u + 1])
+            {
+                int v = net.to[k];
+                if (net.cap[k] > 0 && potential[u] + net.cost[k] < potential[v])
+                {
+                    potential[v] = potential[u] + net.cost[k];
+                    if (!queued[v])
+                    {
+                        queued[v] = true;
+                        q.pb(v);
+                    }
+                }
             }
         }
     }
 
-    // Get prime factorization of k
-    // Returns a vector of pairs {prime, exponent}
-    vpll get_prime_factorization(int k)
+    // SSP with a heap type from the Dijkstra section; dist/parent buffers live across iterations
+    template <typename Heap>
+    pll _ssp(int s, int t, ll limit)
     {
-        ASSERT(k > 0 && k <= max_val, "get_prime_factorization input out of sieve range or non-positive.");
-        vpll factors;
-        if (k == 1)
-            return factors; // Or return {{1,1}} depending on convention
-        while (k > 1)
+        const int n = net.n_nodes;
+        Heap pq(n);
+        vll dist(n);
+        vi parent_arc(n);
+        ll flow_total = 0, cost_total = 0;
+        while (flow_total < limit)
         {
-            int p = spf[k];
-            int count = 0;
-            while (k % p == 0)
+            fill(all(dist), INF);
+            pq.clear();
+            dist[s] = 0;
+            pq.push(s, 0);
+            while (!pq.empty())
             {
-                k /= p;
-                count++;
+                auto [d, u] = pq.pop();
+                if (d > dist[u])
+                    continue;
+                if (u == t)
+                    break; // Nodes not settled yet are clamped to dist[t] below
+                f(k, net.start[u], net.start[u + 1])
+                {
+                    int v = net.to[k];
+                    if (net.cap[k] == 0)
+                        continue;
+                    ll nd = d + net.cost[k] + potential[u] - potential[v];
+                    if (nd < dist[v])
+                    {
+                        dist[v] = nd;
+                        parent_arc[v] = k;
+                        pq.push(v, nd);
+                    }
+                }
             }
-            factors.eb(p, count); // Used eb for pair construction
+            if (dist[t] == INF)
+                break;
+            f(v, 0, n) potential[v] += min(dist[v], dist[t]);
+            ll pushed = limit - flow_total;
+            for (int v = t; v != s; v = net.to[net.rev[parent_arc[v]]])
+                pushed = min(pushed, net.cap[parent_arc[v]]);
+            for (int v = t; v != s; v = net.to[net.rev[parent_arc[v]]])
+            {
+                net.cap[parent_arc[v]] -= pushed;
+                net.cap[net.rev[parent_arc[v]]] += pushed;
+            }
+            flow_total += pushed;
+            cost_total += pushed * (potential[t] - potential[s]);
         }
-        return factors;
+        return {flow_total, cost_total};
     }
 
-    // Get all distinct prime factors of k
-    vll get_distinct_prime_factors(int k)
+    // Cost-scaling refinement: turns the current (feasible) flow into a minimum-cost one
+    void _cost_scaling()
     {
-        ASSERT(k > 0 && k <= max_val, "get_distinct_prime_factors input out of sieve range or non-positive.");
-        vll distinct_factors;
-        if (k == 1)
-            return distinct_factors;
-        while (k > 1)
+        const int n = net.n_nodes, arcs = sz(net.to);
+        const ll scale = n + 1; // eps < 1 / n in original units <=> eps_scaled = 1
+        vll c(arcs), excess(n, 0);
+        ll eps = 0;
+        f(k, 0, arcs)
         {
-            int p = spf[k];
-            distinct_factors.pb(p); // Used pb
-            while (k % p == 0)
+            c[k] = net.cost[k] * scale;
+            eps = max(eps, abs(c[k]));
+        }
+        potential.assign(n, 0);
+        vi cur(n), active;
+        vector<bool> in_queue(n, false);
+        const int alpha = 16;
+        while (eps > 1)
+        {
+            eps = max(1LL, eps / alpha);
+            f(u, 0, n) f(k, net.start[u], net.start[u + 1])
+            { // Saturate every residual arc with negative reduced cost
+                if (net.cap[k] > 0 && c[k] + potential[u] - potential[net.to[k]] < 0)
+                {
+                    excess[u] -= net.cap[k];
+                    excess[net.to[k]] += net.cap[k];
+                    net.cap[net.rev[k]] += net.cap[k];
+                    net.cap[k] = 0;
+                }
+            }
+            active.clear();
+            f(u, 0, n)
             {
-                k /= p;
+                cur[u] = net.start[u];
+                in_queue[u] = excess[u] > 0;
+                if (in_queue[u])
+                    active.pb(u);
+            }
+            for (int head = 0; head < sz(active); head++)
+            { // Discharge in FIFO order
+                int u = active[head];
+                in_queue[u] = false;
+                while (excess[u] > 0)
+                {
+                    if (cur[u] == net.start[u + 1])
+                    { // Relabel: lower the price until some residual arc becomes admissible
+                        ll best = -INF;
+                        f(k, net.start[u], net.start[u + 1])
+                        {
+                            if (net.cap[k] > 0)
+                                best = max(best, potential[net.to[k]] - c[k]);
+                        }
+                        potential[u] = best - eps;
+                        cur[u] = net.start[u];
+                        continue;
+                    }
+                    int k = cur[u], v = net.to[k];
+                    if (net.cap[k] > 0 && c[k] + potential[u] - potential[v] < 0)
+                    {
+                        ll pushed = min(excess[u], net.cap[k]);
+                        net.cap[k] -= pushed;
+                        net.cap[net.rev[k]] += pushed;
+                        excess[u] -= pushed;
+                        excess[v] += pushed;
+                        if (excess[v] > 0 && !in_queue[v])
+                        {
+                            in_queue[v] = true;
+                            active.pb(v);
+                        }
+                    }
+                    else
+                        cur[u]++;
+                }
             }
         }
-        return distinct_factors;
+        forV(potential) e /= scale; // Back to original units: within rounding of a feasible dual
+        _repair_potential();
     }
-};
 
-#if __cplusplus >= 202002L
-template <std::integral T1, std::integral T2>
-constexpr bool isDivisible(T1 n, T2 divisor)
-{
-    if (divisor == 0)
+    // Sends up to `limit` units from s to t at minimum cost; returns {flow, cost}. Continues from
+    // the current flow; cost covers only the newly sent units.
+    pll get_min_cost_flow(int s, int t, ll limit = INF, Method method = SUCCESSIVE_SHORTEST_PATHS)
     {
-        return false;
+        ASSERT(s >= 0 && s < net.n_nodes && t >= 0 && t < net.n_nodes, "MinCostFlow::get_min_cost_flow: Source/sink index out of bounds.");
+        ASSERT(s != t, "MinCostFlow::get_min_cost_flow: Source and sink must differ.");
+        net.build();
+        if (method == COST_SCALING)
+        {
+            ll before = total_cost();
+            DinicMaxFlow dinic(move(net));
+            ll sent = dinic.get_max_flow(s, t, false, limit);
+            net = move(dinic.net);
+            _cost_scaling();
+            return {sent, total_cost() - before};
+        }
+        _repair_potential(); // One pass unless costs are negative or edges were added after a run
+        if (heap == RADIX_HEAP)
+            return _ssp<RadixHeap>(s, t, limit);
+        if (heap == BINARY_HEAP)
+            return _ssp<LazyBinaryHeap>(s, t, limit);
+        return _ssp<IndexedDaryHeap<4>>(s, t, limit);
     }
-    return (n % divisor == 0);
-}
+};
 
-template <std::integral T>
-constexpr bool isOdd(T n)
-{
-    return !isDivisible(n, 2);
-}
-#else
-template <typename T1, typename T2>
-constexpr bool isDivisible(T1 n, T2 divisor)
+// ──────────── GENERIC INPUT/OUTPUT HELPERS ─────────────
+
+// Buffered input reader behind read().
+// Regular files are mmap'ed whole; pipes and terminals are pulled in blocks of `block_size` bytes.
+// A block refill returns as soon as some data is available, so interactive problems still work.
+// Integers are parsed by hand, floats with from_chars (strtold fallback), all straight from the buffer.
+// The reader owns stdin once used: do not mix read() with `cin >>` in the same program.
+// Compile with -DNO_FAST_IO to go back to the cin-based read().
+constexpr int FAST_IO_BUFFER_SIZE = 1 << 16;
+
+struct FastReader
 {
-    if (divisor == 0)
+    FILE *in;
+    const char *cur = nullptr; // Next unread byte
+    const char *end = nullptr; // One past the last valid byte of the current window
+    vector<char> block;        // Refill buffer (unused when the input is mmap'ed)
+    char *mapped = nullptr;    // Base of the mmap'ed file, if any
+    size_t mapped_len = 0;
+    string token;              // Scratch space for float literals
+    void (*on_refill)();       // Called before blocking on more input (fast_reader() flushes output here)
+
+    FastReader(FILE *in_file = stdin, bool allow_mmap = true, int block_size = FAST_IO_BUFFER_SIZE, void (*refill_hook)() = nullptr)
+        : in(in_file), on_refill(refill_hook)
     {
-        return false;
+        ASSERT(in != nullptr, "FastReader: Input stream is null.");
+        ASSERT(block_size > 0, "FastReader: Block size must be positive.");
+#ifdef HAS_POSIX_IO
+        int fd = fileno(in);
+        struct stat st;
+        if (allow_mmap && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+        {
+            off_t offset = lseek(fd, 0, SEEK_CUR);
+            int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+            flags |= MAP_POPULATE;
+#endif
+            void *p = mmap(nullptr, st.st_size, PROT_READ, flags, fd, 0);
+            if (p != MAP_FAILED && offset >= 0 && offset <= st.st_size)
+            {
+                mapped = static_cast<char *>(p);
+                mapped_len = st.st_size;
+                cur = mapped + offset;
+                end = mapped + mapped_len;
+                return;
+            }
+            if (p != MAP_FAILED)
+                munmap(p, st.st_size);
+        }
+#else
+        (void)allow_mmap;
+#endif
+        block.resize(block_size);
+        cur = end = block.data();
     }
-    return (n % divisor == 0);
-}
 
-template <typename T>
-constexpr bool isOdd(T n)
-{
-    return !isDivisible(n, 2);
-}
+    ~FastReader()
+    {
+#ifdef HAS_POSIX_IO
+        if (mapped)
+            munmap(mapped, mapped_len);
 #endif
+    }
 
-// ──────────────── LINEAR ALGEBRA UTILITIES ───────────────
+    FastReader(const FastReader &) = delete;
+    FastReader &operator=(const FastReader &) = delete;
 
-// Matrix struct for matrix exponentiation and other linear algebra operations.
-// Assumes operations are done under a specific modulus, using Mint by default.
-template <typename T = ll, ll Mod = MOD_CONST> // Allow flexible data type and modulus
-struct Matrix
-{
-    int rows, cols;
-    vector<vector<T>> mat;
-    ModularOps<Mod> M; // Modular operations for the given Modulus
+    // Replace the (fully consumed) window with the next block. Returns false at EOF.
+    bool _refill()
+    {
+        if (mapped || block.empty())
+            return false;
+        if (on_refill)
+            on_refill();
+#ifdef HAS_POSIX_IO
+        ssize_t got;
+        do
+        {
+            got = ::read(fileno(in), block.data(), block.size());
+        } while (got < 0 && errno == EINTR);
+#else
+        size_t got = fread(block.data(), 1, block.size(), in);
+#endif
+        if (got <= 0)
+            return false;
+        cur = block.data();
+        end = cur + got;
+        return true;
+    }
 
-    Matrix(int r = 0, int c = 0, T val = 0) : rows(r), cols(c)
+    // Returns the first non-whitespace byte without consuming it, or -1 at EOF.
+    int _skip_spaces()
     {
-        if (r > 0 && c > 0)
+        while (true)
         {
-            mat.assign(r, vector<T>(c, val));
+            while (cur < end && static_cast<unsigned char>(*cur) <= ' ')
+                ++cur;
+            if (cur < end)
+                return static_cast<unsigned char>(*cur);
+            if (!_refill())
+                return -1;
         }
     }
 
-    // Constructor for identity matrix
-    static Matrix identity(int n)
+    // Appends the rest of the current token (up to whitespace or EOF) to `out`.
+    template <typename Container>
+    void _take_token(Container &out)
     {
-        Matrix id(n, n);
-        f(i, 0, n)
-        { // Used f macro
-            id.mat[i][i] = 1;
+        while (true)
+        {
+            const char *start = cur;
+            while (cur < end && static_cast<unsigned char>(*cur) > ' ')
+                ++cur;
+            out.insert(out.end(), start, cur);
+            if (cur < end || !_refill())
+                return;
         }
-        return id;
     }
 
-    // Matrix multiplication: C = A * B
-    Matrix operator*(const Matrix &other) const
+    template <typename T>
+    bool read_integer(T &x)
     {
-        ASSERT(cols == other.rows, "Matrix multiplication: Column count of first matrix must match row count of second matrix.");
-        Matrix result(rows, other.cols);
-        f(i, 0, rows)
-        { // Used f macro
-            f(j, 0, other.cols)
-            { // Used f macro
-                T sum = 0;
-                f(k, 0, cols)
-                { // Used f macro
-                    sum = M.add(sum, M.mul(mat[i][k], other.mat[k][j]));
-                }
-                result.mat[i][j] = sum;
+        x = 0; // Like `cin >>`, a failed numeric read leaves zero behind
+        int c = _skip_spaces();
+        if (c < 0)
+            return false;
+        bool negative = false;
+        if (c == '-' || c == '+')
+        {
+            negative = (c == '-');
+            ++cur;
+        }
+        using U = make_unsigned_t<T>;
+        U value = 0;
+        while (true)
+        {
+            while (cur < end)
+            {
+                unsigned digit = static_cast<unsigned char>(*cur) - '0';
+                if (digit > 9)
+                    break;
+                value = value * 10 + digit;
+                ++cur;
             }
+            if (cur < end || !_refill())
+                break;
         }
-        return result;
+        x = static_cast<T>(negative ? U(0) - value : value);
+        return true;
     }
 
-    // For debugging or printing the matrix
-    void print_matrix() const
+    template <typename T>
+    bool read_floating(T &x)
     {
-        f(i, 0, rows)
-        { // Used f macro
-            f(j, 0, cols)
-            { // Used f macro
-                cout << mat[i][j] << (j == cols - 1 ? "" : " ");
-            }
-            cout << NL;
+        x = 0;
+        if (_skip_spaces() < 0)
+            return false;
+        token.clear();
+        _take_token(token);
+        const char *first = token.data() + (token[0] == '+');
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        if (from_chars(first, token.data() + sz(token), x).ec == errc())
+            return true;
+#endif
+        x = static_cast<T>(strtold(first, nullptr));
+        return true;
+    }
+
+    bool read_char(char &ch)
+    {
+        int c = _skip_spaces();
+        if (c < 0)
+            return false;
+        ch = *cur++;
+        return true;
+    }
+
+    bool read_string(string &s)
+    {
+        if (_skip_spaces() < 0)
+            return false;
+        s.clear();
+        _take_token(s);
+        return true;
+    }
+
+    // Reads one whitespace-separated value, mirroring what `cin >> x` would accept.
+    // Returns false at EOF (numbers are then zeroed, strings and chars left untouched).
+    template <typename T>
+    bool read(T &x)
+    {
+        if constexpr (is_same_v<T, char> || is_same_v<T, signed char> || is_same_v<T, unsigned char>)
+        {
+            char ch;
+            if (!read_char(ch))
+                return false;
+            x = static_cast<T>(ch);
+            return true;
+        }
+        else if constexpr (is_same_v<T, bool>)
+        {
+            int v;
+            bool ok = read_integer(v);
+            x = (v != 0);
+            return ok;
+        }
+        else if constexpr (is_integral_v<T>)
+            return read_integer(x);
+        else if constexpr (is_floating_point_v<T>)
+            return read_floating(x);
+        else if constexpr (is_same_v<T, string>)
+            return read_string(x);
+        else
+        {
+            static_assert(sizeof(T) == 0, "FastReader::read: unsupported type (compile with -DNO_FAST_IO to use cin).");
+            return false;
         }
     }
-};
 
-// Matrix exponentiation (binary exponentiation for matrices)
-// Returns base^exp % Mod. Base must be a square matrix.
-template <typename T, ll Mod>
-Matrix<T, Mod> matrix_power(Matrix<T, Mod> base, ll exp)
-{
-    ASSERT(base.rows == base.cols, "Matrix power: Base matrix must be square.");
-    Matrix<T, Mod> result = Matrix<T, Mod>::identity(base.rows);
-    // ModularOps instances M are already members of base and result, initialized by their constructors.
-    // Re-assigning them here (base.M = ..., result.M = ...) is redundant if Matrix constructor correctly initializes M.
+    template <typename A, typename B>
+    bool read(pair<A, B> &p)
+    {
+        return read(p.fi) && read(p.se);
+    }
 
-    while (exp > 0)
+    template <typename T>
+    bool read(vector<T> &v)
     {
-        if (exp % 2 == 1)
-            result = result * base;
-        base = base * base;
-        exp /= 2;
+        for (auto &element : v)
+            if (!read(element))
+                return false;
+        return true;
     }
-    return result;
-}
+};
 
-// Max Flow - Dinic's Algorithm
-// Generally faster than Edmonds-Karp for many graph types.
-struct DinicMaxFlow
+// Buffered output writer behind print(), printv(), YES and NO.
+// Integers are converted by hand (no locale, no stream state) and the buffer is written out in
+// large blocks; the process-wide writer flushes itself at exit.
+// Floating-point values follow cout's precision and fixed/scientific flags, so
+// `cout << fixed << setprecision(9)` keeps working with print().
+// Output written directly to cout is not ordered with this buffer: call flush_output() in between.
+struct FastWriter
 {
-    struct Edge
+    FILE *out;
+    vector<char> buf;
+    size_t pos = 0;
+
+    FastWriter(FILE *out_file = stdout, int block_size = FAST_IO_BUFFER_SIZE) : out(out_file), buf(block_size)
     {
-        int to;
-        ll capacity;
-        int rev; // Index of the reverse edge in adj[to]
-    };
+        ASSERT(out != nullptr, "FastWriter: Output stream is null.");
+        ASSERT(block_size >= 64, "FastWriter: Block size must be at least 64 bytes.");
+    }
 
-    int n_nodes;
-    vector<vector<Edge>> adj;
-    vi level; // Stores level of each node in the level graph (distance from source)
-    vi ptr;   // Pointer for DFS to keep track of the next edge to explore for a node
+    ~FastWriter() { flush(); }
 
-    DinicMaxFlow(int n = 0) : n_nodes(n)
+    FastWriter(const FastWriter &) = delete;
+    FastWriter &operator=(const FastWriter &) = delete;
+
+    // Hands everything buffered so far to the OS. Call before waiting on an interactive judge.
+    void flush()
     {
-        if (n > 0)
+        if (pos > 0)
+            fwrite(buf.data(), 1, pos, out);
+        pos = 0;
+        fflush(out);
+    }
+
+    void _reserve(size_t len)
+    {
+        if (pos + len > buf.size())
         {
-            adj.assign(n, vector<Edge>());
-            level.resize(n);
-            ptr.resize(n);
+            fwrite(buf.data(), 1, pos, out);
+            pos = 0;
         }
     }
 
-    // Adds a directed edge u->v with capacity cap.
-    void add_edge(int u, int v, ll cap)
+    void write_char(char c)
     {
-        ASSERT(u >= 0 && u < n_nodes && v >= 0 && v < n_nodes, "DinicMaxFlow::add_edge: Node index out of bounds.");
-        ASSERT(cap >= 0, "DinicMaxFlow::add_edge: Capacity must be non-negative.");
-        adj[u].eb(v, cap, static_cast<int>(sz(adj[v])));
-        adj[v].eb(u, 0, static_cast<int>(sz(adj[u]) - 1)); // Residual edge with 0 capacity initially
+        _reserve(1);
+        buf[pos++] = c;
     }
 
-    // BFS to build the level graph and check if sink is reachable.
-    bool _bfs_dinic(int s, int t)
+    void write_chars(const char *s, size_t len)
     {
-        fill(all(level), -1);
-        level[s] = 0;
-        queue<int> q;
-        q.push(s);
-        while (!q.empty())
-        {
-            int u = q.front();
-            q.pop();
-            for (const auto &edge : adj[u])
+        if (len > buf.size())
+        { // Too big to buffer: write it straight through
+            _reserve(buf.size());
+            fwrite(buf.data(), 1, pos, out);
+            pos = 0;
+            fwrite(s, 1, len, out);
+            return;
+        }
+        _reserve(len);
+        memcpy(buf.data() + pos, s, len);
+        pos += len;
+    }
+
+    template <typename T>
+    void write_integer(T x)
+    {
+        static constexpr char digit_pairs[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+        using U = make_unsigned_t<T>;
+        U value = static_cast<U>(x);
+        bool negative = false;
+        if constexpr (is_signed_v<T>)
+        {
+            if (x < 0)
             {
-                if (edge.capacity > 0 && level[edge.to] < 0)
-                {
-                    level[edge.to] = level[u] + 1;
-                    q.push(edge.to);
-                }
+                negative = true;
+                value = U(0) - value;
             }
         }
-        return level[t] != -1; // True if sink t is reachable
+        char tmp[24];
+        char *p = tmp + sizeof(tmp);
+        while (value >= 100)
+        {
+            unsigned idx = static_cast<unsigned>(value % 100) * 2;
+            value /= 100;
+            *--p = digit_pairs[idx + 1];
+            *--p = digit_pairs[idx];
+        }
+        if (value >= 10)
+        {
+            unsigned idx = static_cast<unsigned>(value) * 2;
+            *--p = digit_pairs[idx + 1];
+            *--p = digit_pairs[idx];
+        }
+        else
+            *--p = static_cast<char>('0' + value);
+        if (negative)
+            *--p = '-';
+        write_chars(p, tmp + sizeof(tmp) - p);
     }
 
-    // DFS to send flow along paths in the level graph (finds a blocking flow).
-    // u: current node, t: sink, pushed: flow pushed so far along current path.
-    ll _dfs_dinic(int u, int t, ll pushed)
+    template <typename T>
+    void write_floating(T x)
     {
-        if (pushed == 0)
-            return 0;
-        if (u == t)
-            return pushed; // Reached sink
+        ios_base::fmtflags fmt = cout.flags() & ios_base::floatfield;
+        int precision = static_cast<int>(cout.precision());
+        const char *spec = (fmt == ios_base::fixed) ? "%.*Lf" : (fmt == ios_base::scientific) ? "%.*Le" : "%.*Lg";
+        char tmp[128];
+        int len = snprintf(tmp, sizeof(tmp), spec, precision, static_cast<long double>(x));
+        if (len >= 0 && len < static_cast<int>(sizeof(tmp)))
+            write_chars(tmp, len);
+        else
+        { // Huge fixed-point value or precision: let the stream do it
+            ostringstream oss;
+            oss.flags(cout.flags());
+            oss.precision(precision);
+            oss << x;
+            write(oss.str());
+        }
+    }
 
-        for (int &cid = ptr[u]; cid < sz(adj[u]); ++cid)
+    // Writes one value the way `cout << x` would.
+    template <typename T>
+    void write(const T &x)
+    {
+        if constexpr (is_same_v<T, char> || is_same_v<T, signed char> || is_same_v<T, unsigned char>)
+            write_char(static_cast<char>(x));
+        else if constexpr (is_same_v<T, bool>)
+            write_char(x ? '1' : '0');
+        else if constexpr (is_integral_v<T>)
+            write_integer(x);
+        else if constexpr (is_floating_point_v<T>)
+            write_floating(x);
+        else if constexpr (is_same_v<T, string> || is_same_v<T, string_view>)
+            write_chars(x.data(), x.size());
+        else if constexpr (is_convertible_v<const T &, const char *>)
         {
-            auto &edge = adj[u][cid];
-            if (level[edge.to] != level[u] + 1 || edge.capacity == 0)
-                continue;
-
-            ll tr = _dfs_dinic(edge.to, t, min(pushed, edge.capacity));
-            if (tr == 0)
-                continue; // No flow sent through this path
-
-            edge.capacity -= tr;
-            adj[edge.to][edge.rev].capacity += tr;
-            return tr;
+            const char *s = x;
+            write_chars(s, strlen(s));
+        }
+        else
+        { // User types with their own operator<<
+            ostringstream oss;
+            oss << x;
+            write(oss.str());
         }
-        return 0; // No more flow can be pushed from u in this DFS phase
     }
+};
 
-    ll get_max_flow(int s, int t)
-    {
-        ASSERT(s >= 0 && s < n_nodes && t >= 0 && t < n_nodes, "DinicMaxFlow::get_max_flow: Source/sink index out of bounds.");
-        if (s == t)
-            return INF; // Or 0, by convention
+// Process-wide reader over stdin and writer over stdout, created on first use.
+// The reader flushes pending output whenever it has to wait for more input (like cin.tie).
+inline FastWriter &fast_writer()
+{
+    static FastWriter writer(stdout);
+    return writer;
+}
+
+inline FastReader &fast_reader()
+{
+    static FastReader reader(stdin, true, FAST_IO_BUFFER_SIZE, [] { fast_writer().flush(); });
+    return reader;
+}
+
+// Flush hook for interactive problems: pushes everything printed so far to the judge.
+inline void flush_output()
+{
+#ifndef NO_FAST_IO
+    fast_writer().flush();
+#else
+    cout.flush();
+#endif
+}
+
+#ifndef NO_FAST_IO
+template <typename T, typename... Args>
+void read(T &first, Args &...args)
+{
+    FastReader &in = fast_reader();
+    in.read(first);
+    ((void)in.read(args), ...);
+}
+
+template <typename T>
+void read(vector<T> &v)
+{
+    fast_reader().read(v);
+}
+
+template <typename T, typename... Args>
+void print(const T &first, const Args &...args)
+{
+    FastWriter &out = fast_writer();
+    out.write(first);
+    ((out.write_char(SPACE), out.write(args)), ...);
+    out.write_char(NL);
+}
 
-        ll total_flow = 0;
-        while (_bfs_dinic(s, t))
-        {                      // While sink is reachable in level graph
-            fill(all(ptr), 0); // Reset pointers for DFS for the new level graph
-            while (ll pushed = _dfs_dinic(s, t, INF))
-            {
-                total_flow += pushed;
-            }
-        }
-        return total_flow;
+template <typename T>
+void printv(const vector<T> &v)
+{
+    FastWriter &out = fast_writer();
+    for (const auto &element : v)
+    {
+        out.write(element);
+        out.write_char(SPACE);
     }
-};
-
-// ──────────── GENERIC INPUT/OUTPUT HELPERS ─────────────
+    out.write_char(NL);
+}
+#else
 template <typename T, typename... Args>
 void read(T &first, Args &...args)
 {
@@ -1492,6 +4109,7 @@ void printv(const vector<T> &v)
 #endif
     cout << NL;
 }
+#endif
 
 // Suffix Array and LCP Array Construction
 // Based on an O(N log N) approach using sorting of cyclic shifts/suffixes.
@@ -1667,16 +4285,275 @@ namespace NTT
         return M.power(base, exp);
     }
 
+    // Transform kernel over 32-bit residues for an NTT prime P < 2^30 with primitive root G.
+    // - forward() is decimation-in-frequency (natural order in, bit-reversed order out) and
+    //   inverse() is decimation-in-time (bit-reversed in, natural out), so convolutions never permute.
+    // - Twiddles are stored in Montgomery form, so the Montgomery product of a plain value and a
+    //   twiddle is again a plain value; between butterflies values stay lazily reduced in [0, 2P).
+    // - Root tables and scratch buffers grow on demand and are shared by all calls with the same P.
+    // - Butterflies use AVX2 when compiled with -mavx2 (or a target pragma), scalar code otherwise.
+    template <uint32_t P, uint32_t G = 3>
+    struct Kernel
+    {
+        static_assert(P % 2 == 1 && P < (1u << 30), "NTT::Kernel needs an odd prime below 2^30.");
+        static constexpr uint32_t P2 = 2 * P;
+
+        static constexpr uint32_t _p_inv()
+        { // P^{-1} mod 2^32 by Newton iteration
+            uint32_t x = P;
+            for (int i = 0; i < 5; i++)
+                x *= 2 - P * x;
+            return x;
+        }
+        static constexpr uint32_t P_INV = _p_inv();
+
+        static constexpr int _max_log()
+        {
+            int k = 0;
+            while (((P - 1) >> k) % 2 == 0)
+                k++;
+            return k;
+        }
+        static constexpr int MAX_LOG = _max_log(); // Transforms up to 2^MAX_LOG points
+
+        // a * b * 2^-32 mod P, result in (0, 2P). Needs a * b < P * 2^32 (e.g. a, b < 2P).
+        static uint32_t mont_mul(uint32_t a, uint32_t b)
+        {
+            uint64_t t = static_cast<uint64_t>(a) * b;
+            uint32_t m = static_cast<uint32_t>(t) * P_INV;
+            return static_cast<uint32_t>(t >> 32) - static_cast<uint32_t>((static_cast<uint64_t>(m) * P) >> 32) + P;
+        }
+        static uint32_t reduce2(uint32_t x) { return min(x, x - P2); } // [0, 4P) -> [0, 2P)
+        static uint32_t to_mont(uint64_t x) { return static_cast<uint32_t>((x % P << 32) % P); }
+
+        // roots[half + j] = w_{2 half}^j and iroots[half + j] = w_{2 half}^{-j}, in Montgomery form.
+        static vector<uint32_t> &_roots(bool inverse)
+        {
+            static vector<uint32_t> tables[2];
+            return tables[inverse];
+        }
+
+        static void _prepare(int n)
+        {
+            vector<uint32_t> &w = _roots(false), &iw = _roots(true);
+            int have = sz(w);
+            if (have >= n)
+                return;
+            ASSERT(n <= (1 << MAX_LOG), "NTT::Kernel: Transform size exceeds the prime's 2-adic order.");
+            w.resize(n);
+            iw.resize(n);
+            for (int half = max(have, 1); half < n; half <<= 1)
+            {
+                ll root = ModularOps<P>::power(G, (P - 1) / (2 * half));
+                ll iroot = ModularOps<P>::inv(root);
+                ll cur = 1, icur = 1;
+                f(j, 0, half)
+                {
+                    w[half + j] = to_mont(cur);
+                    iw[half + j] = to_mont(icur);
+                    cur = cur * root % P;
+                    icur = icur * iroot % P;
+                }
+            }
+        }
+
+#ifdef HAS_AVX2
+        static __m256i _mont_mul8(__m256i a, __m256i b)
+        {
+            const __m256i p = _mm256_set1_epi32(P), p_inv = _mm256_set1_epi32(P_INV);
+            __m256i t_even = _mm256_mul_epu32(a, b);
+            __m256i t_odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+            __m256i mp_even = _mm256_mul_epu32(_mm256_mul_epu32(t_even, p_inv), p);
+            __m256i mp_odd = _mm256_mul_epu32(_mm256_mul_epu32(t_odd, p_inv), p);
+            __m256i t_hi = _mm256_blend_epi32(_mm256_srli_epi64(t_even, 32), t_odd, 0b10101010);
+            __m256i mp_hi = _mm256_blend_epi32(_mm256_srli_epi64(mp_even, 32), mp_odd, 0b10101010);
+            return _mm256_add_epi32(_mm256_sub_epi32(t_hi, mp_hi), p);
+        }
+        static __m256i _reduce2_8(__m256i x) { return _mm256_min_epu32(x, _mm256_sub_epi32(x, _mm256_set1_epi32(P2))); }
+#endif
+
+        // Gentleman-Sande butterflies: (x, y) -> (x + y, (x - y) * w)
+        static void _dif_block(uint32_t *a, uint32_t *b, const uint32_t *w, int half)
+        {
+            int j = 0;
+#ifdef HAS_AVX2
+            const __m256i p2 = _mm256_set1_epi32(P2);
+            for (; j + 8 <= half; j += 8)
+            {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + j));
+                __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + j));
+                __m256i wj = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(w + j));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(a + j), _reduce2_8(_mm256_add_epi32(x, y)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(b + j), _mont_mul8(_mm256_add_epi32(_mm256_sub_epi32(x, y), p2), wj));
+            }
+#endif
+            for (; j < half; j++)
+            {
+                uint32_t x = a[j], y = b[j];
+                a[j] = reduce2(x + y);
+                b[j] = mont_mul(x - y + P2, w[j]);
+            }
+        }
+
+        // Cooley-Tukey butterflies: (x, y) -> (x + y * w, x - y * w)
+        static void _dit_block(uint32_t *a, uint32_t *b, const uint32_t *w, int half)
+        {
+            int j = 0;
+#ifdef HAS_AVX2
+            const __m256i p2 = _mm256_set1_epi32(P2);
+            for (; j + 8 <= half; j += 8)
+            {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + j));
+                __m256i y = _mont_mul8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + j)),
+                                       _mm256_loadu_si256(reinterpret_cast<const __m256i *>(w + j)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(a + j), _reduce2_8(_mm256_add_epi32(x, y)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(b + j), _reduce2_8(_mm256_add_epi32(_mm256_sub_epi32(x, y), p2)));
+            }
+#endif
+            for (; j < half; j++)
+            {
+                uint32_t x = a[j], y = mont_mul(b[j], w[j]);
+                a[j] = reduce2(x + y);
+                b[j] = reduce2(x - y + P2);
+            }
+        }
+
+        // In-place forward transform of n = 2^k values in [0, 2P); output is bit-reversed, in [0, 2P).
+        static void forward(uint32_t *a, int n)
+        {
+            _prepare(n);
+            const uint32_t *w = _roots(false).data();
+            for (int half = n >> 1; half >= 1; half >>= 1)
+                for (int i = 0; i < n; i += 2 * half)
+                    _dif_block(a + i, a + i + half, w + half, half);
+        }
+
+        // In-place inverse transform without the 1/n factor; bit-reversed input, natural output in [0, 2P).
+        static void _inverse_unscaled(uint32_t *a, int n)
+        {
+            _prepare(n);
+            const uint32_t *iw = _roots(true).data();
+            for (int half = 1; half < n; half <<= 1)
+                for (int i = 0; i < n; i += 2 * half)
+                    _dit_block(a + i, a + i + half, iw + half, half);
+        }
+
+        // Multiplies every value by the Montgomery-form `scale` and reduces fully into [0, P).
+        static void _scale(uint32_t *a, int n, uint32_t scale)
+        {
+            f(i, 0, n)
+            {
+                uint32_t x = mont_mul(a[i], scale);
+                a[i] = x >= P ? x - P : x;
+            }
+        }
+
+        // In-place inverse transform (bit-reversed in, natural out), fully reduced and divided by n.
+        static void inverse(uint32_t *a, int n)
+        {
+            _inverse_unscaled(a, n);
+            _scale(a, n, to_mont(ModularOps<P>::inv(n)));
+        }
+
+        // Inverse transform of pointwise mont_mul products: the products left a factor 2^-32 behind,
+        // so this scales by 2^32 / n instead of 1 / n. Output is natural order, fully reduced.
+        static void inverse_product(uint32_t *a, int n)
+        {
+            _inverse_unscaled(a, n);
+            _scale(a, n, to_mont((1ULL << 32) % P * ModularOps<P>::inv(n) % P));
+        }
+
+        static vector<uint32_t> &_scratch(int which)
+        {
+            static vector<uint32_t> buffers[3];
+            return buffers[which];
+        }
+
+        template <typename T>
+        static void _load(const vector<T> &src, vector<uint32_t> &dst, int n)
+        {
+            dst.resize(n);
+            int m = sz(src);
+            f(i, 0, m)
+            {
+                ll x = static_cast<ll>(src[i] % static_cast<T>(P));
+                dst[i] = static_cast<uint32_t>(x < 0 ? x + P : x);
+            }
+            fill(dst.begin() + m, dst.begin() + n, 0);
+        }
+
+        // out = a * b with coefficients reduced into [0, P).
+        // `out` may alias `a` or `b`; its capacity and the internal scratch buffers are reused across calls.
+        template <typename T>
+        static void multiply(const vector<T> &a, const vector<T> &b, vector<T> &out)
+        {
+            if (a.empty() || b.empty())
+            {
+                out.clear();
+                return;
+            }
+            const int na = sz(a), nb = sz(b), need = na + nb - 1;
+            vector<uint32_t> &fa = _scratch(0), &fb = _scratch(1);
+            if (min(na, nb) <= 32)
+            { // Schoolbook is faster for a short factor
+                vector<uint32_t> &res = _scratch(2);
+                _load(a, fa, na);
+                _load(b, fb, nb);
+                res.assign(need, 0);
+                f(i, 0, na) f(j, 0, nb) res[i + j] = static_cast<uint32_t>((res[i + j] + static_cast<uint64_t>(fa[i]) * fb[j]) % P);
+                out.resize(need);
+                f(i, 0, need) out[i] = static_cast<T>(res[i]);
+                return;
+            }
+
+            int n = 1;
+            while (n < need)
+                n <<= 1;
+            const bool square = (&a == &b);
+            _load(a, fa, n);
+            forward(fa.data(), n);
+            if (square)
+                f(i, 0, n) fa[i] = mont_mul(fa[i], fa[i]);
+            else
+            {
+                _load(b, fb, n);
+                forward(fb.data(), n);
+                f(i, 0, n) fa[i] = mont_mul(fa[i], fb[i]);
+            }
+            inverse_product(fa.data(), n);
+
+            out.resize(need);
+            f(i, 0, need) out[i] = static_cast<T>(fa[i]);
+        }
+    };
+
+    using DefaultKernel = Kernel<static_cast<uint32_t>(MOD), static_cast<uint32_t>(PRIMITIVE_ROOT)>;
+
+    // Bit-reversal permutation table for size n, cached per size
+    inline const vi &_bit_reverse_table(int n)
+    {
+        static vector<vi> tables(32);
+        int lg = 0;
+        while ((1 << lg) < n)
+            lg++;
+        vi &rev = tables[lg];
+        if (sz(rev) != n)
+        {
+            rev.assign(n, 0);
+            f(i, 1, n) rev[i] = (rev[i >> 1] >> 1) | ((i & 1) ? (n >> 1) : 0);
+        }
+        return rev;
+    }
+
     // Bit-reversal permutation
     inline void _reorder_array(vll &a)
     {
         int n = sz(a); // Used sz
         if (n == 0)
             return;
-        vi rev(n);
+        const vi &rev = _bit_reverse_table(n);
         f(i, 0, n)
         { // Used f macro
-            rev[i] = (rev[i >> 1] >> 1) | ((i & 1) ? (n >> 1) : 0);
             if (i < rev[i])
             {
                 swap(a[i], a[rev[i]]);
@@ -1684,104 +4561,530 @@ namespace NTT
         }
     }
 
-    // Core NTT function
+    // Core NTT function (natural order in and out, size must be a power of two)
     // `invert = true` for inverse NTT
     inline void _transform(vll &a, bool invert)
     {
         int n = sz(a); // Used sz
         if (n == 0)
             return;
-        _reorder_array(a);
-
-        for (int len = 2; len <= n; len <<= 1)
-        { // Cannot use simple f/cf due to len <<= 1
-            ll wlen = power_ntt(PRIMITIVE_ROOT, (MOD - 1) / len);
-            if (invert)
+        ASSERT((n & (n - 1)) == 0, "NTT::_transform: Size must be a power of two.");
+        vector<uint32_t> &buf = DefaultKernel::_scratch(2);
+        const vi &rev = _bit_reverse_table(n);
+        buf.resize(n);
+        if (!invert)
+        {
+            DefaultKernel::_load(a, buf, n);
+            DefaultKernel::forward(buf.data(), n);
+            f(i, 0, n)
             {
-                wlen = M.inv(wlen);
-            }
-            for (int i = 0; i < n; i += len)
-            { // Cannot use simple f/cf due to i += len
-                ll w = 1;
-                f(j, 0, len / 2)
-                { // Used f macro
-                    ll u = a[i + j];
-                    ll v = M.mul(a[i + j + len / 2], w);
-                    a[i + j] = M.add(u, v);
-                    a[i + j + len / 2] = M.sub(u, v);
-                    w = M.mul(w, wlen);
-                }
+                uint32_t x = buf[rev[i]];
+                a[i] = x >= static_cast<uint32_t>(MOD) ? x - static_cast<uint32_t>(MOD) : x;
             }
         }
-
-        if (invert)
+        else
         {
-            ll n_inv = M.inv(n);
-            forV(a)
-            {                        // Used forV macro, element is `e`
-                e = M.mul(e, n_inv); // Corrected: use `e` instead of `x`
+            f(i, 0, n)
+            {
+                ll x = a[rev[i]] % MOD;
+                buf[i] = static_cast<uint32_t>(x < 0 ? x + MOD : x);
             }
+            DefaultKernel::inverse(buf.data(), n);
+            f(i, 0, n) a[i] = buf[i];
         }
     }
 
+    // Multiplies two polynomials into a caller-provided buffer: out = a * b mod 998244353.
+    // `out` is resized to |a| + |b| - 1 (empty if either input is empty) and may alias an input;
+    // reusing it across calls avoids reallocating for repeated convolutions.
+    inline void multiply_polynomials_into(const vll &a, const vll &b, vll &out)
+    {
+        DefaultKernel::multiply(a, b, out);
+    }
+
     // Multiplies two polynomials a and b (coefficient vectors)
     // Returns the coefficient vector of a*b.
     inline vll multiply_polynomials(const vll &a_in, const vll &b_in)
     { // Renamed to avoid conflict with 'a' in forV
-        if (a_in.empty() || b_in.empty())
-            return {};
+        vll result;
+        multiply_polynomials_into(a_in, b_in, result);
+        return result;
+    }
 
-        vll fa(all(a_in)), fb(all(b_in));         // Used all
-        int result_deg = sz(a_in) + sz(b_in) - 2; // Used sz
-        if (result_deg < 0)
-            result_deg = 0; // Handle empty or constant product
-
-        int n_ntt = 1; // Renamed n to n_ntt to avoid conflict
-        while (n_ntt < sz(a_in) + sz(b_in) - 1)
-            n_ntt <<= 1; // Used sz. Smallest power of 2 >= result size
-        if (sz(a_in) == 0 && sz(b_in) == 0)
-            n_ntt = 0; // Used sz. Product of two empty polys is empty
-        else if (n_ntt == 0 && (sz(a_in) > 0 || sz(b_in) > 0))
-            n_ntt = 1; // Used sz. product of const and empty
-        if (n_ntt == 0 && (sz(a_in) > 0 || sz(b_in) > 0) && (sz(a_in) + sz(b_in) - 1 > 0))
-            n_ntt = 1; // Used sz. for single element product, result is size 1
-                       // e.g. {c1} * {c2} = {c1c2}, size 1
-                       // {c} * {} -> {}, size 0
-                       // {} * {} -> {}, size 0
-        // handle sz(a)+sz(b)-1 = 0 case (e.g. [5]*[] ) -> n=0? No, should be size of result_deg+1
-        // if result_deg is -1 (e.g. a={c}, b={}), then result size should be 0.
-        // if result_deg is 0 (e.g. a={c1}, b={c2}), result size is 1. n should be 1.
-
-        int final_size = result_deg + 1;
-        if (final_size < 0)
-            final_size = 0;
-
-        // Reset n_ntt based on final_size for NTT processing length
-        n_ntt = 1;
-        while (n_ntt < final_size)
-            n_ntt <<= 1;
-        if (final_size == 0)
-            n_ntt = 0; // if product is truly empty
-
-        fa.resize(n_ntt); // Pad with zeros
-        fb.resize(n_ntt);
-
-        if (n_ntt > 0)
-        { // Only transform if there are elements
-            _transform(fa, false);
-            _transform(fb, false);
-            f(i, 0, n_ntt)
-            { // Used f macro
-                fa[i] = M.mul(fa[i], fb[i]);
+    // ── Arbitrary modulus: three-prime NTT + CRT ──
+    // Coefficients are convolved exactly modulo three NTT primes (product ~2^86) and recombined with Garner's
+    // method. Moduli below 2^31 are convolved directly; larger ones (up to 2^62) split every coefficient
+    // into 31-bit halves so that each partial convolution still fits below the CRT range.
+    constexpr uint32_t CRT_P1 = 998244353, CRT_P2 = 167772161, CRT_P3 = 469762049; // All have primitive root 3
+
+    // Residues mod P of the partial products: res[0] = a0 * b0 and, when `split`,
+    // res[1] = a0 * b1 + a1 * b0 and res[2] = a1 * b1. All operands are non-negative and below 2^31.
+    template <uint32_t P>
+    void _prime_convolution(const vll &a0, const vll &a1, const vll &b0, const vll &b1, bool split, bool square, int n, vector<uint32_t> (&res)[3])
+    {
+        using K = Kernel<P>;
+        static vector<uint32_t> fa[2], fb[2];
+        const int parts = split ? 2 : 1;
+        f(k, 0, parts)
+        {
+            K::_load(k ? a1 : a0, fa[k], n);
+            K::forward(fa[k].data(), n);
+            if (!square)
+            {
+                K::_load(k ? b1 : b0, fb[k], n);
+                K::forward(fb[k].data(), n);
+            }
+        }
+        const vector<uint32_t> *gb = square ? fa : fb;
+        res[0].resize(n);
+        f(i, 0, n) res[0][i] = K::mont_mul(fa[0][i], gb[0][i]);
+        if (split)
+        {
+            res[1].resize(n);
+            res[2].resize(n);
+            f(i, 0, n)
+            {
+                res[1][i] = K::reduce2(K::mont_mul(fa[0][i], gb[1][i]) + K::mont_mul(fa[1][i], gb[0][i]));
+                res[2][i] = K::mont_mul(fa[1][i], gb[1][i]);
+            }
+        }
+        f(k, 0, split ? 3 : 1) K::inverse_product(res[k].data(), n);
+    }
+
+    // Garner recombination of residues (r1, r2, r3) into the exact value x < P1 * P2 * P3, reduced mod `mod`.
+    struct _CRTReducer
+    {
+        ull mod, p1_mod, p1p2_mod;
+        uint64_t inv_p1_mod_p2, inv_p1p2_mod_p3;
+
+        explicit _CRTReducer(ull mod) : mod(mod), p1_mod(CRT_P1 % mod),
+                                        p1p2_mod(static_cast<ull>(static_cast<unsigned __int128>(CRT_P1) * CRT_P2 % mod)),
+                                        inv_p1_mod_p2(ModularOps<CRT_P2>::inv(CRT_P1)),
+                                        inv_p1p2_mod_p3(ModularOps<CRT_P3>::inv(static_cast<ll>(CRT_P1) * CRT_P2 % CRT_P3)) {}
+
+        ull operator()(uint64_t r1, uint64_t r2, uint64_t r3) const
+        {
+            uint64_t t2 = (r2 + CRT_P2 - r1 % CRT_P2) * inv_p1_mod_p2 % CRT_P2;
+            uint64_t x12 = (r1 + static_cast<uint64_t>(CRT_P1) * t2) % CRT_P3; // r1 + P1 t2 < P1 P2 < 2^58
+            uint64_t t3 = (r3 + CRT_P3 - x12) * inv_p1p2_mod_p3 % CRT_P3;
+            if (mod <= (1ULL << 32))
+                return (r1 + p1_mod * t2 + p1p2_mod * t3) % mod;
+            return static_cast<ull>((r1 + static_cast<unsigned __int128>(p1_mod) * t2 + static_cast<unsigned __int128>(p1p2_mod) * t3) % mod);
+        }
+    };
+
+    // Multiplies two polynomials modulo any 1 <= mod <= 2^62 (not necessarily prime) into a caller-provided buffer.
+    // Same buffer semantics as multiply_polynomials_into: `out` may alias an input and its capacity is reused.
+    inline void multiply_polynomials_mod_into(const vll &a, const vll &b, vll &out, ll mod = MOD_CONST)
+    {
+        ASSERT(mod >= 1 && mod <= (1LL << 62), "NTT::multiply_polynomials_mod_into: Modulus must lie in [1, 2^62].");
+        if (a.empty() || b.empty())
+        {
+            out.clear();
+            return;
+        }
+        const int na = sz(a), nb = sz(b), need = na + nb - 1;
+        const bool square = (&a == &b);
+        const ull m = static_cast<ull>(mod);
+        auto mulmod = [m](ull x, ull y) { return static_cast<ull>(static_cast<unsigned __int128>(x) * y % m); };
+        static vll a0, a1, b0, b1;
+        auto load = [&](const vll &src, vll &lo, vll &hi, bool split)
+        {
+            lo.resize(sz(src));
+            hi.resize(split ? sz(src) : 0);
+            f(i, 0, sz(src))
+            {
+                ll x = src[i] % mod;
+                x += x < 0 ? mod : 0;
+                lo[i] = split ? x & ((1LL << 31) - 1) : x;
+                if (split)
+                    hi[i] = x >> 31;
             }
-            _transform(fa, true);
+        };
+
+        if (min(na, nb) <= 32)
+        { // Schoolbook is faster for a short factor
+            load(a, a0, a1, false);
+            load(b, b0, b1, false);
+            vll &res = a1;
+            res.assign(need, 0);
+            f(i, 0, na) f(j, 0, nb) res[i + j] = static_cast<ll>((static_cast<ull>(res[i + j]) + mulmod(a0[i], b0[j])) % m);
+            out.swap(res);
+            return;
+        }
+
+        int n = 1;
+        while (n < need)
+            n <<= 1;
+        ASSERT(n <= (1 << Kernel<CRT_P1>::MAX_LOG), "NTT::multiply_polynomials_mod_into: Product too long.");
+        const bool split = (m > (1ULL << 31));
+        load(a, a0, a1, split);
+        if (!square)
+            load(b, b0, b1, split);
+        static vector<uint32_t> r1[3], r2[3], r3[3];
+        _prime_convolution<CRT_P1>(a0, a1, b0, b1, split, square, n, r1);
+        _prime_convolution<CRT_P2>(a0, a1, b0, b1, split, square, n, r2);
+        _prime_convolution<CRT_P3>(a0, a1, b0, b1, split, square, n, r3);
+
+        const _CRTReducer crt(m);
+        out.resize(need);
+        if (!split)
+        {
+            f(i, 0, need) out[i] = static_cast<ll>(crt(r1[0][i], r2[0][i], r3[0][i]));
+            return;
+        }
+        const ull shift31 = (1ULL << 31) % m, shift62 = mulmod(shift31, shift31);
+        f(i, 0, need)
+        {
+            ull c0 = crt(r1[0][i], r2[0][i], r3[0][i]);
+            ull c1 = crt(r1[1][i], r2[1][i], r3[1][i]);
+            ull c2 = crt(r1[2][i], r2[2][i], r3[2][i]);
+            out[i] = static_cast<ll>((c0 + mulmod(c1, shift31) + mulmod(c2, shift62)) % m);
         }
+    }
 
-        fa.resize(final_size); // Trim to actual result polynomial size
-        return fa;
+    // Returns a * b with coefficients reduced modulo `mod` (any modulus up to 2^62, e.g. 1e9+7).
+    inline vll multiply_polynomials_mod(const vll &a, const vll &b, ll mod = MOD_CONST)
+    {
+        vll result;
+        multiply_polynomials_mod_into(a, b, result, mod);
+        return result;
     }
 } // namespace NTT
 
+// Formal power series / polynomials over an NTT prime P (default 998244353).
+// Coefficients are kept in [0, P) and c[i] is the coefficient of x^i. Series operations take the
+// number of terms n to produce, i.e. they work modulo x^n.
+//   - inv, log, exp, sqrt, pow: O(n log n) Newton iterations. inv uses the middle-product trick
+//     (five transforms of size 2m per doubling instead of full products of size 4m).
+//   - divmod, operator/, operator%: Euclidean division through the reversed series inverse.
+//   - evaluate, interpolate: multipoint evaluation and interpolation on a subproduct tree, O(n log^2 n).
+template <uint32_t P = static_cast<uint32_t>(NTT::MOD)>
+struct FormalPowerSeries
+{
+    using FPS = FormalPowerSeries;
+    using K = NTT::Kernel<P>;
+    using Ops = ModularOps<P>;
+
+    vll c;
+
+    FormalPowerSeries() = default;
+    FormalPowerSeries(const vll &coeffs) : c(coeffs)
+    {
+        for (ll &x : c)
+            x = Ops::normalize(x);
+    }
+    FormalPowerSeries(initializer_list<ll> coeffs) : FormalPowerSeries(vll(coeffs)) {}
+
+    int size() const { return sz(c); }
+    bool empty() const { return c.empty(); }
+    ll operator[](int i) const { return i < sz(c) ? c[i] : 0; } // Zero past the stored terms
+
+    // First n coefficients, zero-padded
+    FPS pre(int n) const
+    {
+        FPS r;
+        r.c.assign(c.begin(), c.begin() + min(n, size()));
+        r.c.resize(n, 0);
+        return r;
+    }
+
+    // Drops trailing zero coefficients
+    FPS &shrink()
+    {
+        while (!c.empty() && c.back() == 0)
+            c.pop_back();
+        return *this;
+    }
+
+    FPS reversed() const
+    {
+        FPS r = *this;
+        reverse(all(r.c));
+        return r;
+    }
+
+    // Value at x (Horner)
+    ll eval(ll x) const
+    {
+        x = Ops::normalize(x);
+        ll res = 0;
+        for (int i = sz(c) - 1; i >= 0; i--)
+            res = (res * x + c[i]) % P;
+        return res;
+    }
+
+    FPS &operator+=(const FPS &o)
+    {
+        if (sz(o.c) > sz(c))
+            c.resize(sz(o.c), 0);
+        f(i, 0, sz(o.c))
+        {
+            c[i] += o.c[i];
+            if (c[i] >= P)
+                c[i] -= P;
+        }
+        return *this;
+    }
+    FPS &operator-=(const FPS &o)
+    {
+        if (sz(o.c) > sz(c))
+            c.resize(sz(o.c), 0);
+        f(i, 0, sz(o.c))
+        {
+            c[i] -= o.c[i];
+            if (c[i] < 0)
+                c[i] += P;
+        }
+        return *this;
+    }
+    FPS &operator*=(const FPS &o)
+    {
+        K::multiply(c, o.c, c);
+        return *this;
+    }
+    FPS &operator*=(ll k)
+    {
+        k = Ops::normalize(k);
+        for (ll &x : c)
+            x = x * k % P;
+        return *this;
+    }
+    friend FPS operator+(FPS a, const FPS &b) { return a += b; }
+    friend FPS operator-(FPS a, const FPS &b) { return a -= b; }
+    friend FPS operator*(FPS a, const FPS &b) { return a *= b; }
+    friend FPS operator*(FPS a, ll k) { return a *= k; }
+    FPS operator-() const { return FPS() - *this; }
+
+    FPS derivative() const
+    {
+        FPS r;
+        r.c.resize(max(0, size() - 1));
+        f(i, 1, sz(c)) r.c[i - 1] = c[i] * i % P;
+        return r;
+    }
+
+    FPS integral() const
+    {
+        FPS r;
+        r.c.resize(sz(c) + 1, 0);
+        f(i, 0, sz(c)) r.c[i + 1] = c[i] * _inv_int(i + 1) % P;
+        return r;
+    }
+
+    // 1 / this mod x^n; the constant term must be non-zero
+    FPS inv(int n) const
+    {
+        ASSERT(!c.empty() && c[0] != 0, "FormalPowerSeries::inv: Constant term must be non-zero.");
+        FPS res;
+        res.c.assign(1, Ops::inv(c[0]));
+        vector<uint32_t> &fa = _buf(0), &fb = _buf(1);
+        for (int m = 1; m < n; m <<= 1)
+        { // res is correct mod x^m; lift it to x^2m with cyclic products of length 2m
+            const int len = 2 * m;
+            _load_prefix(c, len, fa, len);
+            _load_prefix(res.c, m, fb, len);
+            K::forward(fa.data(), len);
+            K::forward(fb.data(), len);
+            f(i, 0, len) fa[i] = K::mont_mul(fa[i], fb[i]);
+            K::inverse_product(fa.data(), len);
+            // this * res = 1 + e with e = O(x^m); terms wrapped past x^2m land below x^m and are dropped
+            fill(fa.begin(), fa.begin() + m, 0);
+            K::forward(fa.data(), len);
+            f(i, 0, len) fa[i] = K::mont_mul(fa[i], fb[i]);
+            K::inverse_product(fa.data(), len);
+            res.c.resize(len);
+            f(i, m, len) res.c[i] = fa[i] ? P - fa[i] : 0;
+        }
+        res.c.resize(n);
+        return res;
+    }
+
+    // log(this) mod x^n; the constant term must be 1
+    FPS log(int n) const
+    {
+        ASSERT(!c.empty() && c[0] == 1, "FormalPowerSeries::log: Constant term must be 1.");
+        if (n == 0)
+            return FPS();
+        return (pre(n).derivative() * inv(n)).pre(n - 1).integral();
+    }
+
+    // exp(this) mod x^n; the constant term must be 0
+    FPS exp(int n) const
+    {
+        ASSERT(c.empty() || c[0] == 0, "FormalPowerSeries::exp: Constant term must be 0.");
+        FPS g{1};
+        for (int m = 1; m < n; m <<= 1)
+        { // g <- g * (1 - log g + this) mod x^2m
+            FPS t = pre(2 * m) - g.log(2 * m);
+            t.c[0] = Ops::add(t.c[0], 1);
+            g = (g * t).pre(2 * m);
+        }
+        return g.pre(n);
+    }
+
+    // A square root of this mod x^n, or an empty series if none exists
+    FPS sqrt(int n) const
+    {
+        if (n == 0)
+            return FPS();
+        int k = 0;
+        while (k < sz(c) && c[k] == 0)
+            k++;
+        if (k == sz(c) || k / 2 >= n)
+            return FPS(vll(n, 0));
+        ll root = sqrt_mod(c[k], P);
+        if (k % 2 == 1 || root == -1)
+            return FPS();
+        const int len = n - k / 2;
+        FPS b;
+        b.c.assign(c.begin() + k, c.begin() + min(size(), k + len));
+        b *= Ops::inv(c[k]);
+        FPS s{1};
+        const ll inv2 = (P + 1) / 2;
+        for (int m = 1; m < len; m <<= 1)
+            s = (s + (b.pre(2 * m) * s.inv(2 * m)).pre(2 * m)) * inv2; // s <- (s + b / s) / 2
+        s = s.pre(len) * min(root, P - root);
+        s.c.insert(s.c.begin(), k / 2, 0);
+        return s;
+    }
+
+    // this^k mod x^n for any k >= 0
+    FPS pow(ll k, int n) const
+    {
+        ASSERT(k >= 0, "FormalPowerSeries::pow: Exponent must be non-negative.");
+        if (n == 0)
+            return FPS();
+        FPS zeros(vll(n, 0));
+        if (k == 0)
+        {
+            zeros.c[0] = 1;
+            return zeros;
+        }
+        int t = 0;
+        while (t < sz(c) && c[t] == 0)
+            t++;
+        if (t == sz(c) || (t > 0 && k >= (n + t - 1) / t))
+            return zeros;
+        const int shift = static_cast<int>(t * k), len = n - shift;
+        FPS b;
+        b.c.assign(c.begin() + t, c.begin() + min(size(), t + len));
+        b *= Ops::inv(c[t]);
+        FPS r = (b.log(len) * (k % P)).exp(len) * Ops::power(c[t], k);
+        r.c.insert(r.c.begin(), shift, 0);
+        return r;
+    }
+
+    // Euclidean division: {q, r} with this = d * q + r and deg r < deg d
+    pair<FPS, FPS> divmod(const FPS &d_in) const
+    {
+        FPS a = *this, d = d_in;
+        a.shrink();
+        d.shrink();
+        ASSERT(!d.empty(), "FormalPowerSeries::divmod: Division by the zero polynomial.");
+        if (sz(a) < sz(d))
+            return {FPS(), a};
+        const int qn = sz(a) - sz(d) + 1;
+        FPS q = (a.reversed().pre(qn) * d.reversed().inv(qn)).pre(qn).reversed();
+        FPS r = (a - d * q).pre(sz(d) - 1);
+        r.shrink();
+        return {q, r};
+    }
+    friend FPS operator/(const FPS &a, const FPS &b) { return a.divmod(b).fi; }
+    friend FPS operator%(const FPS &a, const FPS &b) { return a.divmod(b).se; }
+
+    // Values at every point of xs
+    vll evaluate(const vll &xs) const
+    {
+        if (xs.empty())
+            return {};
+        vector<FPS> tree(4 * sz(xs));
+        _build_tree(tree, xs, 1, 0, sz(xs));
+        vll out(sz(xs));
+        _evaluate_down(tree, xs, *this % tree[1], 1, 0, sz(xs), out);
+        return out;
+    }
+
+    // The unique polynomial of degree < |xs| through (xs[i], ys[i]); the xs must be distinct mod P
+    static FPS interpolate(const vll &xs, const vll &ys)
+    {
+        ASSERT(sz(xs) == sz(ys), "FormalPowerSeries::interpolate: xs and ys must have the same length.");
+        if (xs.empty())
+            return FPS();
+        const int n = sz(xs);
+        vector<FPS> tree(4 * n);
+        _build_tree(tree, xs, 1, 0, n);
+        vll w(n);
+        _evaluate_down(tree, xs, tree[1].derivative(), 1, 0, n, w);
+        f(i, 0, n) w[i] = Ops::mul(Ops::normalize(ys[i]), Ops::inv(w[i])); // Lagrange weights y_i / prod_{j != i} (x_i - x_j)
+        return _combine(tree, w, 1, 0, n);
+    }
+
+    static ll _inv_int(int i)
+    {
+        static vll invs = {0, 1};
+        while (sz(invs) <= i)
+        {
+            int k = sz(invs);
+            invs.pb((P - P / k) * invs[P % k] % P);
+        }
+        return invs[i];
+    }
+
+    static vector<uint32_t> &_buf(int which)
+    {
+        static vector<uint32_t> buffers[2];
+        return buffers[which];
+    }
+
+    // dst = first len coefficients of src, zero-padded to n
+    static void _load_prefix(const vll &src, int len, vector<uint32_t> &dst, int n)
+    {
+        dst.resize(n);
+        int k = min(len, static_cast<int>(src.size()));
+        f(i, 0, k) dst[i] = static_cast<uint32_t>(src[i]);
+        fill(dst.begin() + k, dst.end(), 0);
+    }
+
+    // tree[node] = prod_{l <= i < r} (x - xs[i])
+    static void _build_tree(vector<FPS> &tree, const vll &xs, int node, int l, int r)
+    {
+        if (r - l == 1)
+        {
+            tree[node] = FPS{-xs[l], 1};
+            return;
+        }
+        int m = (l + r) / 2;
+        _build_tree(tree, xs, 2 * node, l, m);
+        _build_tree(tree, xs, 2 * node + 1, m, r);
+        tree[node] = tree[2 * node] * tree[2 * node + 1];
+    }
+
+    // out[i] = rem(xs[i]) for l <= i < r, where rem is already reduced modulo tree[node]
+    static void _evaluate_down(const vector<FPS> &tree, const vll &xs, const FPS &rem, int node, int l, int r, vll &out)
+    {
+        if (r - l <= 32)
+        { // Horner beats further divisions on small nodes
+            f(i, l, r) out[i] = rem.eval(xs[i]);
+            return;
+        }
+        int m = (l + r) / 2;
+        _evaluate_down(tree, xs, rem % tree[2 * node], 2 * node, l, m, out);
+        _evaluate_down(tree, xs, rem % tree[2 * node + 1], 2 * node + 1, m, r, out);
+    }
+
+    // sum over l <= i < r of w[i] * prod_{j != i} (x - xs[j])
+    static FPS _combine(const vector<FPS> &tree, const vll &w, int node, int l, int r)
+    {
+        if (r - l == 1)
+            return FPS{w[l]};
+        int m = (l + r) / 2;
+        return _combine(tree, w, 2 * node, l, m) * tree[2 * node + 1] + _combine(tree, w, 2 * node + 1, m, r) * tree[2 * node];
+    }
+};
+
+using Poly = FormalPowerSeries<>;
+
 // Heavy-Light Decomposition (HLD)
 // Decomposes a tree into vertex-disjoint paths for efficient path queries/updates
 // when combined with a data structure (e.g., Segment Tree) on the linearized paths.
@@ -1820,18 +5123,19 @@ struct HLD
     }
 
     // First DFS: calculate parent, depth, subtree_size, and identify heavy_child
-    void _dfs_size(int u, int p, int d)
+    template <typename Graph>
+    void _dfs_size(const Graph &g, int u, int p, int d)
     {
         parent[u] = p;
         depth[u] = d;
         subtree_size[u] = 1;
         int max_c_size = 0;
 
-        for (int v : adj[u])
+        for (int v : adjacent(g, u))
         {
             if (v == p)
                 continue;
-            _dfs_size(v, u, d + 1);
+            _dfs_size(g, v, u, d + 1);
             subtree_size[u] += subtree_size[v];
             if (subtree_size[v] > max_c_size)
             {
@@ -1842,7 +5146,8 @@ struct HLD
     }
 
     // Second DFS: build heavy paths, assign head and pos (linearized position)
-    void _dfs_hld(int u, int p, int h)
+    template <typename Graph>
+    void _dfs_hld(const Graph &g, int u, int p, int h)
     {
         head[u] = h;
         pos[u] = cur_pos++;
@@ -1850,14 +5155,14 @@ struct HLD
 
         if (heavy_child[u] != -1)
         {
-            _dfs_hld(heavy_child[u], u, h); // Continue current heavy path
+            _dfs_hld(g, heavy_child[u], u, h); // Continue current heavy path
         }
 
-        for (int v : adj[u])
+        for (int v : adjacent(g, u))
         {
             if (v == p || v == heavy_child[u])
                 continue;
-            _dfs_hld(v, u, v); // Start new heavy path with v as its head
+            _dfs_hld(g, v, u, v); // Start new heavy path with v as its head
         }
     }
 
@@ -1865,14 +5170,31 @@ struct HLD
     // User should initialize a segment tree (or other DS) of size n_nodes afterwards,
     // using the `pos` array to map original node indices to segment tree indices.
     // E.g., for node u, its value is at segment_tree_array[pos[u]].
-    void build(int root = 0)
+    void build(int root = 0) { _build(adj, root); }
+
+    // Build straight from a tree in CSR form (both directions stored); add_edge is not needed
+    template <typename W>
+    void build(const CSRGraph<W> &g, int root = 0)
+    {
+        n_nodes = g.n;
+        parent.assign(n_nodes, 0);
+        depth.assign(n_nodes, 0);
+        subtree_size.assign(n_nodes, 0);
+        heavy_child.assign(n_nodes, -1);
+        head.assign(n_nodes, 0);
+        pos.assign(n_nodes, 0);
+        _build(g, root);
+    }
+
+    template <typename Graph>
+    void _build(const Graph &g, int root)
     {
         if (n_nodes == 0)
             return;
         ASSERT(root >= 0 && root < n_nodes, "HLD::build: Root index out of bounds.");
         cur_pos = 0;
-        _dfs_size(root, root, 0);   // parent of root is root itself, depth 0
-        _dfs_hld(root, root, root); // root is head of its own path
+        _dfs_size(g, root, root, 0);   // parent of root is root itself, depth 0
+        _dfs_hld(g, root, root, root); // root is head of its own path
     }
 
     // Helper to get LCA (using simple поднимаемся по предкам, then by depth)
@@ -1890,6 +5212,18 @@ struct HLD
         return (depth[u] < depth[v]) ? u : v;
     }
 
+    // LCAs of all (u, v) pairs in input order via tarjan_offline_lca (pos is a preorder of the tree)
+    vi get_lca_batch(const vector<pii> &queries) const
+    {
+        vi order(cur_pos);
+        f(u, 0, n_nodes)
+        {
+            if (subtree_size[u] > 0) // Reached by build()
+                order[pos[u]] = u;
+        }
+        return tarjan_offline_lca(order, parent, queries);
+    }
+
     // Process path from u to ancestor `anc` (inclusive of u, exclusive of anc if anc is parent of head[u] on different path)
     // Or inclusive of anc if on same heavy path.
     // Calls `func(start_pos, end_pos)` for each segment on the path in linearized array.
@@ -0,0 +1,503 @@
+#include "../include/cp_utils.hpp"
+using namespace std;
+
+// Side-by-side benchmarks for the performance-critical components.
+// Build in contest mode so ASSERT/DEBUG compile away:
+//     g++ -std=c++23 -O2 tests/benchmark_components.cpp -o bench && ./bench
+// Each benchmark prints one row per variant; checksums guard against dead-code elimination.
+
+void report(const string &name, ll ms, ll checksum)
+{
+    cout << left << setw(44) << name << right << setw(8) << ms << " ms   (checksum " << checksum << ")" << NL;
+}
+
+void bench_fast_reader()
+{
+    cout << NL << "── read(): 10^7 integers ──" << NL;
+    const int N = 10'000'000;
+    const string path = (filesystem::temp_directory_path() / "cp_bench_ints.txt").string();
+    {
+        mt19937 rng(12345);
+        uniform_int_distribution<int> dist(-1'000'000'000, 1'000'000'000);
+        FILE *out = fopen(path.c_str(), "w");
+        f(i, 0, N) fprintf(out, "%d%c", dist(rng), (i % 10 == 9) ? '\n' : ' ');
+        fclose(out);
+    }
+
+    {
+        ifstream fin(path);
+        streambuf *saved = cin.rdbuf(fin.rdbuf());
+        Timer timer;
+        ll sum = 0;
+        int x;
+        f(i, 0, N)
+        {
+            cin >> x;
+            sum += x;
+        }
+        report("cin >> (sync_with_stdio off)", timer.elapsed(), sum);
+        cin.rdbuf(saved);
+    }
+
+    for (bool use_mmap : {false, true})
+    {
+        FILE *in = fopen(path.c_str(), "r");
+        Timer timer;
+        FastReader reader(in, use_mmap);
+        ll sum = 0;
+        int x;
+        f(i, 0, N)
+        {
+            reader.read(x);
+            sum += x;
+        }
+        report(use_mmap ? "FastReader (mmap)" : "FastReader (64 KiB blocks)", timer.elapsed(), sum);
+        fclose(in);
+    }
+    remove(path.c_str());
+}
+
+void bench_fast_writer()
+{
+    cout << NL << "── print(): 10^7 integers ──" << NL;
+    const int N = 10'000'000;
+    const string path = (filesystem::temp_directory_path() / "cp_bench_out.txt").string();
+    vi values(N);
+    mt19937 rng(12345);
+    for (int &x : values)
+        x = static_cast<int>(rng() >> 1) - (1 << 30);
+
+    {
+        ofstream fout(path);
+        streambuf *saved = cout.rdbuf(fout.rdbuf());
+        Timer timer;
+        f(i, 0, N) cout << values[i] << NL;
+        cout.flush();
+        ll ms = timer.elapsed();
+        cout.rdbuf(saved);
+        report("cout <<", ms, filesystem::file_size(path));
+    }
+
+    {
+        FILE *out_file = fopen(path.c_str(), "w");
+        Timer timer;
+        {
+            FastWriter out(out_file);
+            f(i, 0, N)
+            {
+                out.write(values[i]);
+                out.write_char(NL);
+            }
+        }
+        ll ms = timer.elapsed();
+        fclose(out_file);
+        report("FastWriter", ms, filesystem::file_size(path));
+    }
+    remove(path.c_str());
+}
+
+// x = x * y + z over four independent chains, so the loop measures throughput rather than latency.
+template <typename Step>
+ll run_mod_chains(int iterations, Step step)
+{
+    ll x[4] = {1, 2, 3, 4};
+    f(i, 0, iterations) f(c, 0, 4) x[c] = step(x[c], i);
+    return x[0] ^ x[1] ^ x[2] ^ x[3];
+}
+
+template <typename MI>
+ll run_modint_chains(int iterations)
+{
+    MI x[4] = {1, 2, 3, 4};
+    const MI y = 123456789, z = 987654321;
+    f(i, 0, iterations) f(c, 0, 4) x[c] = x[c] * y + z;
+    return x[0].val() ^ x[1].val() ^ x[2].val() ^ x[3].val();
+}
+
+void bench_modint()
+{
+    cout << NL << "── mul+add mod 1e9+7: 4 x 5*10^7 steps ──" << NL;
+    const int N = 50'000'000;
+    {
+        Timer timer;
+        ll res = run_mod_chains(N, [](ll x, ll) { return Mint::add(Mint::mul(x, 123456789), 987654321); });
+        report("ModularOps", timer.elapsed(), res);
+    }
+    {
+        Timer timer;
+        ll res = run_modint_chains<MontgomeryModInt<MOD_CONST>>(N);
+        report("MontgomeryModInt", timer.elapsed(), res);
+    }
+    {
+        Timer timer;
+        ll res = run_modint_chains<BarrettModInt<MOD_CONST>>(N);
+        report("BarrettModInt", timer.elapsed(), res);
+    }
+}
+
+void bench_ntt()
+{
+    cout << NL << "── NTT: 5 products of two 10^6-term polynomials ──" << NL;
+    const int N = 1'000'000;
+    mt19937 rng(1);
+    vll a(N), b(N), out;
+    for (ll &x : a)
+        x = rng() % NTT::MOD;
+    for (ll &x : b)
+        x = rng() % NTT::MOD;
+    Timer timer;
+    ll checksum = 0;
+    f(rep, 0, 5)
+    {
+        NTT::multiply_polynomials_into(a, b, out);
+        checksum ^= out[rep * 12345];
+    }
+#ifdef HAS_AVX2
+    report("multiply_polynomials_into (AVX2)", timer.elapsed(), checksum);
+#else
+    report("multiply_polynomials_into (scalar)", timer.elapsed(), checksum);
+#endif
+}
+
+void bench_ntt_arbitrary_mod()
+{
+    cout << NL << "── Three-prime NTT: 2 products of two 10^6-term polynomials ──" << NL;
+    const int N = 1'000'000;
+    mt19937_64 rng(1);
+    vll a(N), b(N), out;
+    for (ll mod : {static_cast<ll>(MOD_CONST), (1LL << 62) - 57})
+    {
+        for (ll &x : a)
+            x = static_cast<ll>(rng() % mod);
+        for (ll &x : b)
+            x = static_cast<ll>(rng() % mod);
+        Timer timer;
+        ll checksum = 0;
+        f(rep, 0, 2)
+        {
+            NTT::multiply_polynomials_mod_into(a, b, out, mod);
+            checksum ^= out[rep * 12345];
+        }
+        report(mod == MOD_CONST ? "multiply_polynomials_mod (1e9+7)" : "multiply_polynomials_mod (2^62 - 57)", timer.elapsed(), checksum);
+    }
+}
+
+void bench_fps()
+{
+    cout << NL << "── Formal power series: 10^6 terms ──" << NL;
+    const int N = 1'000'000;
+    mt19937 rng(1);
+    Poly a;
+    a.c.resize(N);
+    for (ll &x : a.c)
+        x = rng() % NTT::MOD;
+    a.c[0] = 1;
+    {
+        Timer timer;
+        Poly r = a.inv(N);
+        report("Poly::inv", timer.elapsed(), r[N - 1]);
+    }
+    {
+        Timer timer;
+        Poly r = a.log(N);
+        report("Poly::log", timer.elapsed(), r[N - 1]);
+    }
+    a.c[0] = 0;
+    {
+        Timer timer;
+        Poly r = a.exp(N);
+        report("Poly::exp", timer.elapsed(), r[N - 1]);
+    }
+}
+
+void bench_lca()
+{
+    const int N = 500'000, Q = 1'000'000;
+    for (bool deep : {false, true})
+    {
+        cout << NL << "── LCA: 10^6 queries on a " << (deep ? "deep (parent within 50)" : "random") << " 5*10^5-node tree ──" << NL;
+        mt19937 rng(1);
+        vector<pii> edges;
+        f(v, 1, N) edges.pb(deep ? static_cast<int>(max<ll>(0, v - 1 - rng() % 50)) : static_cast<int>(rng() % v), v);
+        vector<pii> queries(Q);
+        for (auto &[u, v] : queries)
+            u = rng() % N, v = rng() % N;
+        for (int variant : {0, 1, 2})
+        {
+            LCA lca(N);
+            for (auto [u, v] : edges)
+                lca.add_edge(u, v);
+            lca.build(0, variant == 1 ? LCA::EULER_TOUR : LCA::BINARY_LIFTING);
+            Timer timer;
+            ll checksum = 0;
+            if (variant == 2)
+            {
+                for (int x : lca.get_lca_batch(queries))
+                    checksum += x;
+            }
+            else
+            {
+                for (auto [u, v] : queries)
+                    checksum += lca.get_lca(u, v);
+            }
+            const char *names[] = {"get_lca (binary lifting)", "get_lca (Euler tour)", "get_lca_batch (Tarjan)"};
+            report(names[variant], timer.elapsed(), checksum);
+        }
+    }
+}
+
+void bench_lazy_segtree()
+{
+    cout << NL << "── Range add / range sum: 10^6 operations on 10^6 - 3 elements ──" << NL;
+    const int N = 1'000'000 - 3, Q = 1'000'000;
+    mt19937 rng(1);
+    vll arr(N);
+    for (ll &x : arr)
+        x = rng() % 1000;
+    vector<array<int, 3>> ops(Q);
+    for (auto &[kind, l, r] : ops)
+    {
+        kind = rng() % 2, l = rng() % N, r = rng() % N;
+        if (l > r)
+            swap(l, r);
+    }
+    auto run = [&](auto &seg, const string &name)
+    {
+        Timer timer;
+        ll checksum = 0;
+        for (auto [kind, l, r] : ops)
+        {
+            if (kind)
+                seg.update(l, r, l % 100);
+            else
+                checksum += seg.query(l, r);
+        }
+        report(name, timer.elapsed(), checksum);
+    };
+    SegTreeLazy<ll, ll> recursive(arr);
+    run(recursive, "SegTreeLazy (recursive)");
+    SegTreeAddSum<> bottom_up(arr);
+    run(bottom_up, "SegTreeAddSum (bottom-up LazySegTree)");
+}
+
+void bench_segtree_search()
+{
+    cout << NL << "── First index with prefix sum > k: 10^6 searches on 10^6 elements ──" << NL;
+    const int N = 1'000'000, Q = 1'000'000;
+    mt19937 rng(1);
+    vll arr(N);
+    for (ll &x : arr)
+        x = rng() % 1000;
+    const ll total = accumulate(all(arr), 0LL);
+    vll ks(Q);
+    for (ll &k : ks)
+        k = static_cast<ll>(rng() % total);
+    SegTreeAddSum<> seg(arr);
+    {
+        Timer timer;
+        ll checksum = 0;
+        for (ll k : ks)
+        { // Binary search over prefix queries: O(log^2 n)
+            int lo = 0, hi = N;
+            while (lo < hi)
+            {
+                int mid = (lo + hi) / 2;
+                if (seg.query(0, mid) > k)
+                    hi = mid;
+                else
+                    lo = mid + 1;
+            }
+            checksum += lo;
+        }
+        report("binary search over query()", timer.elapsed(), checksum);
+    }
+    {
+        Timer timer;
+        ll checksum = 0;
+        for (ll k : ks)
+            checksum += seg.max_right(0, [k](ll sum) { return sum <= k; });
+        report("max_right descent", timer.elapsed(), checksum);
+    }
+}
+
+void bench_persistent_segtree()
+{
+    cout << NL << "── PersistentSegTree: 10^5 elements, 10^5 versions, 10^6 historical queries ──" << NL;
+    const int N = 100'000, U = 100'000, Q = 1'000'000;
+    mt19937 rng(1);
+    vll arr(N);
+    for (ll &x : arr)
+        x = rng() % 1000;
+    Timer timer;
+    PersistentSegTree<ll> pst(N, U);
+    vi roots = {pst.build(arr)};
+    f(t, 0, U) roots.pb(pst.update(roots[rng() % sz(roots)], rng() % N, static_cast<ll>(rng() % 100)));
+    ll checksum = 0;
+    f(q, 0, Q)
+    {
+        int l = rng() % N, r = rng() % N;
+        checksum += pst.query(roots[rng() % sz(roots)], min(l, r), max(l, r));
+    }
+    report("build + updates + queries", timer.elapsed(), checksum);
+    cout << "    arena: " << sz(pst.pool) << " nodes, " << sz(pst.pool) * sizeof(PersistentSegTree<ll>::Node) / (1 << 20) << " MiB" << NL;
+}
+
+void bench_csr_graph()
+{
+    cout << NL << "── Dijkstra: 5*10^5 nodes, 2*10^6 random undirected edges ──" << NL;
+    const int N = 500'000, M = 2'000'000;
+    mt19937 rng(1);
+    vector<tuple<int, int, int>> edges(M);
+    for (auto &[u, v, w] : edges)
+        u = rng() % N, v = rng() % N, w = rng() % 1'000'000;
+    {
+        Timer timer;
+        vector<vector<pii>> adj(N);
+        for (auto [u, v, w] : edges)
+            adj[u].eb(v, w), adj[v].eb(u, w);
+        ll build_ms = timer.elapsed();
+        vector<ll> dist = dijkstra(0, N, adj);
+        report("vector<vector<pii>> (build " + to_string(build_ms) + " ms)", timer.elapsed(), dist[N / 2] ^ dist[N - 1]);
+    }
+    {
+        Timer timer;
+        auto g = CSRGraph<int>::from_weighted_edges(N, edges);
+        ll build_ms = timer.elapsed();
+        vector<ll> dist = dijkstra(0, g);
+        report("CSRGraph (build " + to_string(build_ms) + " ms)", timer.elapsed(), dist[N / 2] ^ dist[N - 1]);
+    }
+}
+
+void bench_dijkstra_heaps()
+{
+    cout << NL << "── Dijkstra on a 1000 x 1000 grid, random weights < 10^4 ──" << NL;
+    const int R = 1000, C = 1000, N = R * C;
+    mt19937 rng(1);
+    vector<tuple<int, int, int>> edges;
+    f(r, 0, R) f(c, 0, C)
+    {
+        if (c + 1 < C)
+            edges.eb(r * C + c, r * C + c + 1, rng() % 10'000);
+        if (r + 1 < R)
+            edges.eb(r * C + c, (r + 1) * C + c, rng() % 10'000);
+    }
+    auto g = CSRGraph<int>::from_weighted_edges(N, edges);
+    const char *names[] = {"lazy binary heap", "radix heap", "indexed 4-ary heap"};
+    for (DijkstraHeap heap : {BINARY_HEAP, RADIX_HEAP, DARY_HEAP})
+    {
+        Timer timer;
+        vector<ll> dist = dijkstra(0, g, heap);
+        report(names[heap], timer.elapsed(), dist[N / 2] ^ dist[N - 1]);
+    }
+    {
+        Timer timer;
+        vector<ll> dist = dijkstra(0, g, RADIX_HEAP, (R / 4) * C + C / 4);
+        report("radix heap, early exit at (250, 250)", timer.elapsed(), dist[(R / 4) * C + C / 4]);
+    }
+}
+
+void bench_shortest_path_batch()
+{
+    const int R = 300, C = 300, N = R * C, S = 256;
+    const int threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    cout << NL << "── Dijkstra from 256 sources on a 300 x 300 grid (" << threads << " hardware threads) ──" << NL;
+    mt19937 rng(1);
+    vector<tuple<int, int, int>> edges;
+    f(r, 0, R) f(c, 0, C)
+    {
+        if (c + 1 < C)
+            edges.eb(r * C + c, r * C + c + 1, rng() % 10'000);
+        if (r + 1 < R)
+            edges.eb(r * C + c, (r + 1) * C + c, rng() % 10'000);
+    }
+    auto g = CSRGraph<int>::from_weighted_edges(N, edges);
+    vi sources(S);
+    for (int &x : sources)
+        x = rng() % N;
+    {
+        Timer timer;
+        ll checksum = 0;
+        for (int s : sources)
+            checksum += dijkstra(s, g, RADIX_HEAP)[N - 1];
+        report("sequential dijkstra() calls", timer.elapsed(), checksum);
+    }
+    vi thread_counts = {1};
+    if (threads > 1)
+        thread_counts.pb(threads);
+    for (int t : thread_counts)
+    {
+        Timer timer;
+        vector<ll> matrix = dijkstra_batch_matrix(sources, N, g, RADIX_HEAP, t);
+        ll checksum = 0;
+        f(i, 0, S) checksum += matrix[static_cast<size_t>(i) * N + N - 1];
+        report("dijkstra_batch_matrix, " + to_string(t) + " thread(s)", timer.elapsed(), checksum);
+    }
+}
+
+// Bipartite matching network: s -> L -> R -> t, unit capacities
+vector<tuple<int, int, ll>> matching_network(int L, int R, int M, mt19937 &rng)
+{
+    vector<tuple<int, int, ll>> edges;
+    f(i, 0, L) edges.eb(0, 2 + i, 1);
+    f(j, 0, R) edges.eb(2 + L + j, 1, 1);
+    f(k, 0, M) edges.eb(2 + rng() % L, 2 + L + rng() % R, 1);
+    return edges;
+}
+
+// Layered network: s -> layer 0 -> ... -> layer D-1 -> t, random capacities up to 10^9
+vector<tuple<int, int, ll>> layered_network(int D, int W, int out_deg, mt19937 &rng)
+{
+    vector<tuple<int, int, ll>> edges;
+    auto node = [W](int d, int i) { return 2 + d * W + i; };
+    f(i, 0, W) edges.eb(0, node(0, i), static_cast<ll>(rng() % 1'000'000'000));
+    f(d, 0, D - 1) f(i, 0, W) f(k, 0, out_deg) edges.eb(node(d, i), node(d + 1, rng() % W), static_cast<ll>(rng() % 1'000'000'000));
+    f(i, 0, W) edges.eb(node(D - 1, i), 1, static_cast<ll>(rng() % 1'000'000'000));
+    return edges;
+}
+
+void bench_dinic()
+{
+    mt19937 rng(1);
+    const int L = 200'000, R = 200'000;
+    auto matching = matching_network(L, R, 1'000'000, rng);
+    auto layered = layered_network(50, 2000, 5, rng);
+    const pair<const char *, const vector<tuple<int, int, ll>> *> cases[] = {
+        {"bipartite matching, 4*10^5 + 10^6 edges", &matching},
+        {"layered, 50 x 2000 nodes, random capacities", &layered}};
+    for (auto [title, edges] : cases)
+    {
+        cout << NL << "── Max flow: " << title << " ──" << NL;
+        int n = 0;
+        for (auto [u, v, c] : *edges)
+            n = max({n, u + 1, v + 1});
+        for (bool scaling : {false, true})
+        {
+            DinicMaxFlow mf(n);
+            for (auto [u, v, c] : *edges)
+                mf.add_edge(u, v, c);
+            Timer timer;
+            ll flow = mf.get_max_flow(0, 1, scaling);
+            report(scaling ? "DinicMaxFlow (capacity scaling)" : "DinicMaxFlow", timer.elapsed(), flow);
+        }
+    }
+}
+
+int main()
+{
+    FASTINOUT;
+    bench_fast_reader();
+    bench_fast_writer();
+    bench_modint();
+    bench_ntt();
+    bench_ntt_arbitrary_mod();
+    bench_fps();
+    bench_lca();
+    bench_lazy_segtree();
+    bench_segtree_search();
+    bench_persistent_segtree();
+    bench_csr_graph();
+    bench_dijkstra_heaps();
+    bench_shortest_path_batch();
+    bench_dinic();
+    return 0;
+}
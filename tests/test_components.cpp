@@ -179,30 +179,1304 @@ void test_modular_arithmetic()
     TEST_PASS("Modular Arithmetic");
 }
 
+void test_fast_reader()
+{
+    DEBUG_SECTION("📥 Fast Input Reader Testing");
+    TIMER_START(fast_reader_test);
+
+    DEBUG_FUNC();
+    const string input = "  42 -17\n9223372036854775807 3.25 -1e-3\nhello w 7 8\n1 2 3\n99";
+
+    // Exercise both the mmap'ed path and the block path with a tiny block to split tokens.
+    for (int mode = 0; mode < 2; mode++)
+    {
+        FILE *tmp = tmpfile();
+        ASSERT(tmp != nullptr, "FastReader: tmpfile() failed");
+        fputs(input.c_str(), tmp);
+        fflush(tmp);
+        rewind(tmp);
+
+        FastReader in(tmp, mode == 0, 3);
+        int a, b;
+        ll big;
+        double d1, d2;
+        string word;
+        char ch;
+        pii pr;
+        vi v(3);
+        ASSERT(in.read(a) && in.read(b), "FastReader: Failed to read ints");
+        ASSERT(in.read(big) && in.read(d1) && in.read(d2), "FastReader: Failed to read ll/double");
+        ASSERT(in.read(word) && in.read(ch) && in.read(pr) && in.read(v), "FastReader: Failed to read string/char/pair/vector");
+        DEBUG("Parsed:", a, b, big, d1, d2, word, ch, pr, v);
+
+        ASSERT(a == 42 && b == -17, "FastReader: Wrong int values");
+        ASSERT(big == LLONG_MAX, "FastReader: Wrong ll value");
+        ASSERT(abs(d1 - 3.25) < EPS && abs(d2 + 1e-3) < EPS, "FastReader: Wrong double values");
+        ASSERT(word == "hello" && ch == 'w', "FastReader: Wrong string/char values");
+        ASSERT(pr == pii(7, 8), "FastReader: Wrong pair values");
+        ASSERT(v == vi({1, 2, 3}), "FastReader: Wrong vector values");
+
+        int last, past_end = -5;
+        ASSERT(in.read(last) && last == 99, "FastReader: Wrong last value");
+        ASSERT(!in.read(past_end) && past_end == 0, "FastReader: Reading past EOF should fail and zero the value");
+        fclose(tmp);
+    }
+
+    TIMER_END(fast_reader_test);
+    TEST_PASS("Fast Input Reader");
+}
+
+void test_fast_writer()
+{
+    DEBUG_SECTION("📤 Fast Output Writer Testing");
+    TIMER_START(fast_writer_test);
+
+    DEBUG_FUNC();
+    FILE *tmp = tmpfile();
+    ASSERT(tmp != nullptr, "FastWriter: tmpfile() failed");
+    ostringstream expected;
+    {
+        FastWriter out(tmp, 64); // Tiny buffer to force intermediate block writes
+        vll values = {0, 7, -5, 1234567890123LL, LLONG_MIN, LLONG_MAX};
+        for (ll x : values)
+        {
+            out.write(x);
+            out.write_char(SPACE);
+            expected << x << SPACE;
+        }
+        out.write(ULLONG_MAX);
+        out.write("|text|");
+        out.write(string(100, 'z'));
+        out.write(true);
+        out.write('c');
+        out.write(2.5);
+        out.write(1.0 / 3);
+        expected << ULLONG_MAX << "|text|" << string(100, 'z') << true << 'c' << 2.5 << 1.0 / 3;
+        out.flush();
+    }
+    rewind(tmp);
+    string written;
+    for (int c; (c = fgetc(tmp)) != EOF;)
+        written += static_cast<char>(c);
+    fclose(tmp);
+    DEBUG_VAR(written);
+    ASSERT(written == expected.str(), "FastWriter: Output should match what cout would print");
+
+    TIMER_END(fast_writer_test);
+    TEST_PASS("Fast Output Writer");
+}
+
+void test_modint()
+{
+    DEBUG_SECTION("⚙️ Montgomery / Barrett ModInt Testing");
+    TIMER_START(modint_test);
+
+    DEBUG_FUNC();
+    mt19937_64 rng(7);
+    INFO("Cross-checking ModInt against ModularOps...");
+    f(iter, 0, 2000)
+    {
+        ll a = static_cast<ll>(rng() % 4'000'000'000ULL) - 2'000'000'000LL;
+        ll b = static_cast<ll>(rng() % 4'000'000'000ULL) - 2'000'000'000LL;
+        FastMint ma(a), mb(b);
+        BarrettModInt<MOD_CONST> ba(a), bb(b);
+        ASSERT((ma * mb).val() == Mint::mul(a, b) && (ba * bb).val() == Mint::mul(a, b), "ModInt: mul mismatch");
+        ASSERT((ma + mb).val() == Mint::add(a, b) && (ba - bb).val() == Mint::sub(a, b), "ModInt: add/sub mismatch");
+        if (ma != FastMint(0))
+            ASSERT((ma * ma.inv()).val() == 1 && (ba / ba).val() == 1, "ModInt: inverse mismatch");
+    }
+    ASSERT(FastMint(2).pow(10).val() == 1024, "ModInt: 2^10 should be 1024");
+
+    // Even modulus goes through Barrett
+    using Even = ModInt<1'000'000'000>;
+    static_assert(is_same_v<Even, BarrettModInt<1'000'000'000>>, "ModInt: even modulus should select Barrett");
+    ASSERT((Even(999'999'999) * Even(999'999'999)).val() == 1, "ModInt: Barrett even-modulus mul");
+    ASSERT((Even(3) * Even(3).inv()).val() == 1, "ModInt: Barrett even-modulus inverse");
+
+    INFO("Checking division-free hot loops...");
+    precompute_factorials();
+    ASSERT(nCr_mod(10, 3) == 120 && nCr_mod(2000000, 1000000) == Mint::mul(fact[2000000], Mint::mul(invFact[1000000], invFact[1000000])), "Combinatorics: nCr mismatch");
+    ASSERT(Mint::mul(fact[123456], invFact[123456]) == 1, "Combinatorics: fact * invFact should be 1");
+
+    Matrix<ll> fib(2, 2);
+    fib.mat = {{1, 1}, {1, 0}};
+    ASSERT(matrix_power(fib, 90).mat[0][1] == 2880067194370816120LL % MOD_CONST, "Matrix: F(90) mod p mismatch");
+
+    vll prod = NTT::multiply_polynomials({1, 2, 3}, {4, 5});
+    ASSERT(prod == vll({4, 13, 22, 15}), "NTT: (1+2x+3x^2)(4+5x) mismatch");
+
+    TIMER_END(modint_test);
+    TEST_PASS("ModInt Engine");
+}
+
+void test_ntt()
+{
+    DEBUG_SECTION("🌀 NTT Polynomial Multiplication Testing");
+    TIMER_START(ntt_test);
+
+    DEBUG_FUNC();
+    mt19937 rng(2024);
+    auto naive = [](const vll &a, const vll &b)
+    {
+        vll c(sz(a) + sz(b) - 1, 0);
+        f(i, 0, sz(a)) f(j, 0, sz(b)) c[i + j] = Mint1::add(c[i + j], Mint1::mul(a[i], b[j]));
+        return c;
+    };
+    auto random_poly = [&](int len)
+    {
+        vll p(len);
+        for (ll &x : p)
+            x = static_cast<ll>(rng() % NTT::MOD) - (rng() % 4 == 0 ? NTT::MOD : 0); // Some negatives
+        return p;
+    };
+
+    INFO("Comparing against schoolbook multiplication...");
+    vll out;
+    for (int na : {1, 5, 33, 64, 100, 257})
+        for (int nb : {1, 40, 129})
+        {
+            vll a = random_poly(na), b = random_poly(nb);
+            NTT::multiply_polynomials_into(a, b, out);
+            ASSERT(out == naive(a, b), "NTT: Product mismatch against schoolbook");
+        }
+
+    INFO("Checking squaring and aliasing the output with an input...");
+    vll a = random_poly(300);
+    vll expected = naive(a, a);
+    NTT::multiply_polynomials_into(a, a, a);
+    ASSERT(a == expected, "NTT: In-place squaring mismatch");
+
+    INFO("Checking the natural-order transform round trip...");
+    vll t = random_poly(256), original = t;
+    for (ll &x : original)
+        x = Mint1::normalize(x);
+    NTT::_transform(t, false);
+    ll direct = 0;
+    for (int i = 255; i >= 0; i--)
+        direct = Mint1::add(Mint1::mul(direct, NTT::power_ntt(NTT::PRIMITIVE_ROOT, (NTT::MOD - 1) / 256 * 3)), original[i]);
+    ASSERT(t[3] == direct, "NTT: Forward transform should evaluate at w^k in natural order");
+    NTT::_transform(t, true);
+    ASSERT(t == original, "NTT: Inverse transform should restore the input");
+
+    TIMER_END(ntt_test);
+    TEST_PASS("NTT Polynomial Multiplication");
+}
+
+void test_ntt_arbitrary_mod()
+{
+    DEBUG_SECTION("🔢 Arbitrary-Modulus Polynomial Multiplication Testing");
+    TIMER_START(ntt_mod_test);
+
+    DEBUG_FUNC();
+    mt19937_64 rng(7);
+    auto naive = [](const vll &a, const vll &b, ll mod)
+    {
+        vll c(sz(a) + sz(b) - 1, 0);
+        auto norm = [mod](ll x) { return (x % mod + mod) % mod; };
+        f(i, 0, sz(a)) f(j, 0, sz(b)) c[i + j] = static_cast<ll>((static_cast<__int128>(c[i + j]) + static_cast<__int128>(norm(a[i])) * norm(b[j])) % mod);
+        return c;
+    };
+
+    INFO("Comparing against schoolbook multiplication for small and 62-bit moduli...");
+    vll out;
+    for (ll mod : {1LL, 2LL, static_cast<ll>(MOD_CONST), (1LL << 31) - 1, (1LL << 31) + 11, 4'611'686'018'427'387'847LL, 1LL << 62})
+        for (int na : {1, 20, 33, 150})
+            for (int nb : {7, 64, 200})
+            {
+                vll a(na), b(nb);
+                for (ll &x : a)
+                    x = static_cast<ll>(rng() >> 1) - (rng() % 3 == 0 ? LLONG_MAX / 2 : 0); // Some negatives
+                for (ll &x : b)
+                    x = static_cast<ll>(rng() % static_cast<ull>(mod));
+                NTT::multiply_polynomials_mod_into(a, b, out, mod);
+                ASSERT(out == naive(a, b, mod), "NTT: Arbitrary-modulus product mismatch");
+            }
+
+    INFO("Checking worst-case coefficients and squaring...");
+    for (ll mod : {static_cast<ll>(MOD_CONST), 1LL << 62})
+    {
+        vll a(3000, mod - 1);
+        vll expected = naive(a, a, mod);
+        ASSERT(NTT::multiply_polynomials_mod(a, a, mod) == expected, "NTT: Worst-case product mismatch");
+        NTT::multiply_polynomials_mod_into(a, a, a, mod);
+        ASSERT(a == expected, "NTT: In-place squaring mismatch");
+    }
+
+    TIMER_END(ntt_mod_test);
+    TEST_PASS("Arbitrary-Modulus Polynomial Multiplication");
+}
+
+void test_formal_power_series()
+{
+    DEBUG_SECTION("📈 Formal Power Series Testing");
+    TIMER_START(fps_test);
+
+    DEBUG_FUNC();
+    mt19937 rng(99);
+    auto random_poly = [&](int len, ll constant)
+    {
+        Poly p;
+        p.c.resize(len);
+        for (ll &x : p.c)
+            x = rng() % NTT::MOD;
+        if (len > 0)
+            p.c[0] = constant;
+        return p;
+    };
+    auto one = [](int n)
+    {
+        Poly p(vll(n, 0));
+        p.c[0] = 1;
+        return p;
+    };
+
+    INFO("Checking inv, log and exp...");
+    for (int n : {1, 2, 7, 64, 300, 1000})
+    {
+        Poly a = random_poly(n, 1 + rng() % 1000);
+        ASSERT((a * a.inv(n)).pre(n).c == one(n).c, "FPS: a * inv(a) should be 1");
+        Poly b = random_poly(n, 1);
+        Poly lb = b.log(n);
+        ASSERT(sz(lb) == n && lb[0] == 0, "FPS: log should have n terms and zero constant");
+        ASSERT((b * lb.derivative()).pre(n - 1).c == b.derivative().pre(n - 1).c, "FPS: (log b)' should equal b' / b");
+        ASSERT(lb.exp(n).c == b.c, "FPS: exp(log b) should restore b");
+    }
+    Poly ex = Poly{0, 1}.exp(10);
+    ll fact = 1;
+    f(i, 0, 10)
+    {
+        ASSERT(Mint1::mul(ex[i], fact) == 1, "FPS: exp(x) should be sum x^i / i!");
+        fact = Mint1::mul(fact, i + 1);
+    }
+
+    INFO("Checking sqrt and pow...");
+    for (int n : {1, 5, 100, 513})
+    {
+        Poly a = random_poly(n, 0);
+        a.c[0] = 0;
+        Poly sq = (a * a).pre(n + 7); // x^2k-led squares exercise the shift
+        if (n > 1)
+            sq.c[0] = sq.c[1] = 0;
+        Poly r = sq.sqrt(n);
+        ASSERT(sz(r) == n && (r * r).pre(n).c == sq.pre(n).c, "FPS: sqrt(s)^2 should equal s");
+        Poly b = random_poly(n, rng() % 5);
+        Poly naive = one(n);
+        f(k, 0, 6)
+        {
+            ASSERT(b.pow(k, n).c == naive.c, "FPS: pow mismatch against repeated multiplication");
+            naive = (naive * b).pre(n);
+        }
+    }
+    ASSERT((Poly{0, 1}.sqrt(4).empty()), "FPS: x has no square root");
+    ASSERT((Poly{0, 0, 1}.pow(1'000'000'000'000LL, 50).c == vll(50, 0)), "FPS: huge powers of x^2 vanish");
+
+    INFO("Checking division, multipoint evaluation and interpolation...");
+    for (int na : {1, 10, 200, 700})
+        for (int nd : {1, 3, 150})
+        {
+            Poly a = random_poly(na, rng() % 7), d = random_poly(nd, rng() % 7);
+            d.c.back() = 1 + rng() % 100;
+            auto [q, r] = a.divmod(d);
+            ASSERT(r.size() < d.size(), "FPS: Remainder degree must be below the divisor's");
+            ASSERT((d * q + r).shrink().c == Poly(a).shrink().c, "FPS: a should equal d * q + r");
+        }
+    Poly p = random_poly(400, 3);
+    vll xs(600);
+    for (ll &x : xs)
+        x = rng() % NTT::MOD;
+    vll ys = p.evaluate(xs);
+    f(i, 0, sz(xs)) ASSERT(ys[i] == p.eval(xs[i]), "FPS: Multipoint evaluation mismatch");
+    xs.resize(400);
+    ys.resize(400);
+    ASSERT(Poly::interpolate(xs, ys).c == p.c, "FPS: Interpolation should recover the polynomial");
+
+    TIMER_END(fps_test);
+    TEST_PASS("Formal Power Series");
+}
+
+void test_lca()
+{
+    DEBUG_SECTION("🌲 LCA Testing");
+    TIMER_START(lca_test);
+
+    DEBUG_FUNC();
+    mt19937 rng(31);
+    INFO("Comparing both modes against naive parent climbing...");
+    for (int n : {1, 2, 10, 257, 3000})
+    {
+        vi par(n, 0);
+        LCA lift(n), euler(n);
+        f(v, 1, n)
+        {
+            par[v] = (rng() % 4 == 0) ? v - 1 : rng() % v; // Mix of long chains and bushy parts
+            lift.add_edge(par[v], v);
+            euler.add_edge(v, par[v]);
+        }
+        lift.build(0, LCA::BINARY_LIFTING);
+        euler.build(0, LCA::EULER_TOUR);
+        auto naive_lca = [&](int u, int v)
+        {
+            while (lift.depth[u] > lift.depth[v])
+                u = par[u];
+            while (lift.depth[v] > lift.depth[u])
+                v = par[v];
+            while (u != v)
+                u = par[u], v = par[v];
+            return u;
+        };
+        f(q, 0, 2000)
+        {
+            int u = rng() % n, v = rng() % n;
+            int expected = naive_lca(u, v);
+            ASSERT(lift.get_lca(u, v) == expected, "LCA: Binary lifting mismatch");
+            ASSERT(euler.get_lca(u, v) == expected, "LCA: Euler tour mismatch");
+            ASSERT(lift.get_dist(u, v) == euler.get_dist(u, v), "LCA: Distance mismatch between modes");
+            int k = rng() % (lift.depth[u] + 2), anc = (k > lift.depth[u]) ? -1 : u;
+            if (anc != -1)
+                f(step, 0, k) anc = par[anc];
+            ASSERT(lift.get_kth_ancestor(u, k) == anc, "LCA: Binary lifting k-th ancestor mismatch");
+            ASSERT(euler.get_kth_ancestor(u, k) == anc, "LCA: Euler tour k-th ancestor mismatch");
+        }
+    }
+
+    INFO("Building on a 2*10^5-node chain (no recursion)...");
+    const int n = 200'000;
+    for (LCA::Mode mode : {LCA::BINARY_LIFTING, LCA::EULER_TOUR})
+    {
+        LCA chain(n);
+        f(v, 1, n) chain.add_edge(v - 1, v);
+        chain.build(0, mode);
+        ASSERT(chain.get_lca(n - 1, n / 2) == n / 2 && chain.get_kth_ancestor(n - 1, n - 1) == 0, "LCA: Chain queries mismatch");
+    }
+
+    TIMER_END(lca_test);
+    TEST_PASS("LCA");
+}
+
+void test_lca_batch()
+{
+    DEBUG_SECTION("📦 Batch Offline LCA Testing");
+    TIMER_START(lca_batch_test);
+
+    DEBUG_FUNC();
+    mt19937 rng(17);
+    for (int n : {1, 2, 50, 5000})
+    {
+        LCA lca(n);
+        HLD hld(n);
+        f(v, 1, n)
+        {
+            int p = (rng() % 3 == 0) ? v - 1 : rng() % v;
+            lca.add_edge(p, v);
+            hld.add_edge(p, v);
+        }
+        int root = rng() % n;
+        lca.build(root);
+        hld.build(root);
+        vector<pii> queries(3 * n);
+        for (auto &[u, v] : queries)
+            u = rng() % n, v = (rng() % 5 == 0) ? u : rng() % n;
+        vi from_lca = lca.get_lca_batch(queries), from_hld = hld.get_lca_batch(queries);
+        f(i, 0, sz(queries))
+        {
+            int expected = lca.get_lca(queries[i].fi, queries[i].se);
+            ASSERT(from_lca[i] == expected, "LCA::get_lca_batch mismatch");
+            ASSERT(from_hld[i] == expected, "HLD::get_lca_batch mismatch");
+        }
+    }
+
+    TIMER_END(lca_batch_test);
+    TEST_PASS("Batch Offline LCA");
+}
+
+void test_lazy_segtree()
+{
+    DEBUG_SECTION("🌳 Lazy Segment Tree Testing");
+    TIMER_START(lazy_segtree_test);
+
+    DEBUG_FUNC();
+    mt19937 rng(5);
+    INFO("Checking SegTreeLazy on non-power-of-two sizes...");
+    for (int n : {1, 3, 5, 6, 7, 100, 1000})
+    {
+        vll arr(n);
+        for (ll &x : arr)
+            x = rng() % 100;
+        SegTreeLazy<ll, ll> seg(arr);
+        f(op, 0, 300)
+        {
+            int l = rng() % n, r = rng() % n;
+            if (l > r)
+                swap(l, r);
+            if (rng() % 2)
+            {
+                ll v = rng() % 50;
+                seg.update(l, r, v);
+                f(i, l, r + 1) arr[i] += v;
+            }
+            else
+            {
+                ASSERT(seg.query(l, r) == accumulate(arr.begin() + l, arr.begin() + r + 1, 0LL), "SegTreeLazy: Sum mismatch");
+            }
+        }
+    }
+
+    INFO("Checking LazySegTree policies against a naive array...");
+    auto run = [&](auto seg, auto apply_naive, auto fold_naive, auto random_action)
+    {
+        int n = seg.n;
+        vll arr(n);
+        f(i, 0, n) arr[i] = seg.get(i);
+        f(op, 0, 600)
+        {
+            int l = rng() % n, r = rng() % n;
+            if (l > r)
+                swap(l, r);
+            int kind = rng() % 3;
+            if (kind == 0)
+            {
+                auto act = random_action();
+                seg.update(l, r, act);
+                f(i, l, r + 1) arr[i] = apply_naive(act, arr[i]);
+            }
+            else if (kind == 1)
+            {
+                ASSERT(seg.query(l, r) == fold_naive(arr, l, r), "LazySegTree: Query mismatch");
+            }
+            else
+            {
+                ll v = rng() % 1000;
+                seg.set(l, v);
+                arr[l] = v;
+                ASSERT(seg.get(l) == v, "LazySegTree: set/get mismatch");
+            }
+        }
+    };
+    auto sum = [](const vll &a, int l, int r) { return accumulate(a.begin() + l, a.begin() + r + 1, 0LL); };
+    auto mn = [](const vll &a, int l, int r) { return *min_element(a.begin() + l, a.begin() + r + 1); };
+    auto mx = [](const vll &a, int l, int r) { return *max_element(a.begin() + l, a.begin() + r + 1); };
+    auto add = [](ll v, ll x) { return x + v; };
+    auto rand_add = [&]() { return static_cast<ll>(rng() % 200) - 100; };
+    for (int n : {1, 2, 7, 64, 100, 333})
+    {
+        vll init(n);
+        for (ll &x : init)
+            x = rng() % 1000;
+        run(SegTreeAddSum<>(init), add, sum, rand_add);
+        run(SegTreeAddMin<>(init), add, mn, rand_add);
+        run(SegTreeAddMax<>(init), add, mx, rand_add);
+        auto assign = [](const AssignAction<SumMonoid<>>::F &act, ll x) { return act.set ? act.val : x; };
+        auto rand_assign = [&]() { return AssignAction<SumMonoid<>>::F(static_cast<ll>(rng() % 1000)); };
+        run(SegTreeAssignSum<>(init), assign, sum, rand_assign);
+        run(SegTreeAssignMin<>(init), [](const AssignAction<MinMonoid<>>::F &act, ll x) { return act.set ? act.val : x; }, mn,
+            [&]() { return AssignAction<MinMonoid<>>::F(static_cast<ll>(rng() % 1000)); });
+        run(SegTreeAssignMax<>(init), [](const AssignAction<MaxMonoid<>>::F &act, ll x) { return act.set ? act.val : x; }, mx,
+            [&]() { return AssignAction<MaxMonoid<>>::F(static_cast<ll>(rng() % 1000)); });
+    }
+
+    INFO("Checking range affine with modular values...");
+    const int n = 77;
+    vector<FastMint1> arr(n);
+    f(i, 0, n) arr[i] = static_cast<ll>(rng() % 1000);
+    SegTreeAffineSum<FastMint1> aff(arr);
+    f(op, 0, 500)
+    {
+        int l = rng() % n, r = rng() % n;
+        if (l > r)
+            swap(l, r);
+        if (rng() % 2)
+        {
+            FastMint1 a = static_cast<ll>(rng()), b = static_cast<ll>(rng());
+            aff.update(l, r, {a, b});
+            f(i, l, r + 1) arr[i] = a * arr[i] + b;
+        }
+        else
+        {
+            FastMint1 expected = 0;
+            f(i, l, r + 1) expected += arr[i];
+            ASSERT(aff.query(l, r) == expected, "LazySegTree: Affine sum mismatch");
+        }
+    }
+
+    TIMER_END(lazy_segtree_test);
+    TEST_PASS("Lazy Segment Tree");
+}
+
+void test_segtree_search_and_beats()
+{
+    DEBUG_SECTION("🔎 Segment Tree Search & Beats Testing");
+    TIMER_START(segtree_beats_test);
+
+    DEBUG_FUNC();
+    mt19937 rng(8);
+    INFO("Checking max_right / min_left against linear scans...");
+    for (int n : {1, 5, 16, 100, 257})
+    {
+        vll arr(n);
+        for (ll &x : arr)
+            x = rng() % 20;
+        SegTreeAddSum<> seg(arr);
+        f(op, 0, 400)
+        {
+            int l = rng() % n, r = rng() % n;
+            if (l > r)
+                swap(l, r);
+            ll v = rng() % 10;
+            seg.update(l, r, v);
+            f(i, l, r + 1) arr[i] += v;
+
+            int from = rng() % (n + 1);
+            ll k = rng() % 400;
+            int expected = from;
+            for (ll acc = 0; expected < n && acc + arr[expected] <= k; expected++)
+                acc += arr[expected];
+            ASSERT(seg.max_right(from, [&](ll s) { return s <= k; }) == expected, "LazySegTree::max_right mismatch");
+
+            int to = static_cast<int>(rng() % (n + 1)) - 1;
+            int expected_left = to + 1;
+            for (ll acc = 0; expected_left > 0 && acc + arr[expected_left - 1] <= k; expected_left--)
+                acc += arr[expected_left - 1];
+            ASSERT(seg.min_left(to, [&](ll s) { return s <= k; }) == expected_left, "LazySegTree::min_left mismatch");
+        }
+    }
+
+    INFO("Checking SegTreeBeats against a naive array...");
+    for (int n : {1, 2, 9, 100, 1000})
+    {
+        vll arr(n);
+        for (ll &x : arr)
+            x = static_cast<ll>(rng() % 2001) - 1000;
+        SegTreeBeats beats(arr);
+        f(op, 0, 2000)
+        {
+            int l = rng() % n, r = rng() % n;
+            if (l > r)
+                swap(l, r);
+            ll x = static_cast<ll>(rng() % 2001) - 1000;
+            switch (rng() % 6)
+            {
+            case 0:
+                beats.chmin(l, r, x);
+                f(i, l, r + 1) arr[i] = min(arr[i], x);
+                break;
+            case 1:
+                beats.chmax(l, r, x);
+                f(i, l, r + 1) arr[i] = max(arr[i], x);
+                break;
+            case 2:
+                beats.add(l, r, x / 10);
+                f(i, l, r + 1) arr[i] += x / 10;
+                break;
+            case 3:
+                ASSERT(beats.query_sum(l, r) == accumulate(arr.begin() + l, arr.begin() + r + 1, 0LL), "SegTreeBeats: Sum mismatch");
+                break;
+            case 4:
+                ASSERT(beats.query_max(l, r) == *max_element(arr.begin() + l, arr.begin() + r + 1), "SegTreeBeats: Max mismatch");
+                break;
+            default:
+                ASSERT(beats.query_min(l, r) == *min_element(arr.begin() + l, arr.begin() + r + 1), "SegTreeBeats: Min mismatch");
+            }
+        }
+    }
+
+    TIMER_END(segtree_beats_test);
+    TEST_PASS("Segment Tree Search & Beats");
+}
+
+void test_persistent_segtree()
+{
+    DEBUG_SECTION("🕰️ Persistent Segment Tree Testing");
+    TIMER_START(persistent_segtree_test);
+
+    DEBUG_FUNC();
+    mt19937 rng(11);
+    INFO("Checking every historical version after random updates...");
+    for (int n : {1, 2, 13, 200})
+    {
+        const int updates = 500;
+        PersistentSegTree<ll> pst(n, updates);
+        vector<vll> history = {vll(n)};
+        for (ll &x : history[0])
+            x = rng() % 100;
+        vi roots = {pst.build(history[0])};
+        const size_t capacity = pst.pool.capacity();
+        f(t, 0, updates)
+        {
+            int base = rng() % sz(roots), pos = rng() % n;
+            vll next = history[base];
+            if (rng() % 2)
+            {
+                ll delta = static_cast<ll>(rng() % 100) - 50;
+                next[pos] += delta;
+                roots.pb(pst.update(roots[base], pos, delta));
+            }
+            else
+            {
+                next[pos] = rng() % 100;
+                roots.pb(pst.set(roots[base], pos, next[pos]));
+            }
+            history.pb(next);
+        }
+        ASSERT(pst.pool.capacity() == capacity, "PersistentSegTree: Arena should not grow after reserve");
+        f(q, 0, 1000)
+        {
+            int v = rng() % sz(roots), l = rng() % n, r = rng() % n;
+            if (l > r)
+                swap(l, r);
+            ASSERT(pst.query(roots[v], l, r) == accumulate(history[v].begin() + l, history[v].begin() + r + 1, 0LL), "PersistentSegTree: Historical sum mismatch");
+        }
+    }
+
+    INFO("Checking k-th smallest in a range over prefix versions...");
+    const int n = 300;
+    vi a(n);
+    for (int &x : a)
+        x = rng() % 50;
+    PersistentSegTree<int> counts(50, n);
+    vi roots = {counts.empty_root()};
+    f(i, 0, n) roots.pb(counts.update(roots.back(), a[i], 1));
+    f(q, 0, 500)
+    {
+        int l = rng() % n, r = rng() % n;
+        if (l > r)
+            swap(l, r);
+        vi part(a.begin() + l, a.begin() + r + 1);
+        sort(all(part));
+        int k = rng() % sz(part) + 1;
+        ASSERT(counts.kth(roots[l], roots[r + 1], k) == part[k - 1], "PersistentSegTree: k-th smallest mismatch");
+    }
+
+    TIMER_END(persistent_segtree_test);
+    TEST_PASS("Persistent Segment Tree");
+}
+
+void test_fenwick_variants()
+{
+    DEBUG_SECTION("🌲 Fenwick Tree Variants Testing");
+    TIMER_START(fenwick_variants_test);
+
+    DEBUG_FUNC();
+    mt19937 rng(12);
+    INFO("Checking O(n) build and lower_bound...");
+    for (int n : {1, 2, 7, 64, 1000})
+    {
+        vll arr(n);
+        for (ll &x : arr)
+            x = rng() % 10; // Non-negative (zeros included) for lower_bound
+        FenwickTree<ll> ft(arr);
+        ll prefix = 0;
+        f(i, 0, n)
+        {
+            prefix += arr[i];
+            ASSERT(ft.query(i) == prefix, "Fenwick: Linear build prefix mismatch");
+        }
+        f(q, 0, 200)
+        {
+            ll k = rng() % (prefix + 3);
+            int expected = 0;
+            for (ll acc = 0; expected < n && acc + arr[expected] < k; expected++)
+                acc += arr[expected];
+            ASSERT(ft.lower_bound(k) == expected, "Fenwick: lower_bound mismatch");
+        }
+    }
+
+    INFO("Checking range-add / range-sum...");
+    for (int n : {1, 5, 300})
+    {
+        vll arr(n);
+        for (ll &x : arr)
+            x = static_cast<ll>(rng() % 100) - 50;
+        RangeFenwickTree<ll> rft(arr);
+        f(op, 0, 500)
+        {
+            int l = rng() % n, r = rng() % n;
+            if (l > r)
+                swap(l, r);
+            if (rng() % 2)
+            {
+                ll v = static_cast<ll>(rng() % 100) - 50;
+                rft.update(l, r, v);
+                f(i, l, r + 1) arr[i] += v;
+            }
+            else
+            {
+                ASSERT(rft.query_range(l, r) == accumulate(arr.begin() + l, arr.begin() + r + 1, 0LL), "RangeFenwickTree: Sum mismatch");
+            }
+        }
+    }
+
+    INFO("Checking 2D rectangle sums...");
+    const int n = 23, m = 17;
+    vector<vll> grid(n, vll(m, 0));
+    FenwickTree2D<ll> ft2(n, m);
+    f(op, 0, 2000)
+    {
+        int x1 = rng() % n, x2 = rng() % n, y1 = rng() % m, y2 = rng() % m;
+        if (op % 2 == 0)
+        {
+            ll v = static_cast<ll>(rng() % 100) - 50;
+            ft2.update(x1, y1, v);
+            grid[x1][y1] += v;
+            continue;
+        }
+        if (x1 > x2)
+            swap(x1, x2);
+        if (y1 > y2)
+            swap(y1, y2);
+        ll expected = 0;
+        cf(x, x1, x2) cf(y, y1, y2) expected += grid[x][y];
+        ASSERT(ft2.query_rect(x1, y1, x2, y2) == expected, "FenwickTree2D: Rectangle sum mismatch");
+    }
+
+    TIMER_END(fenwick_variants_test);
+    TEST_PASS("Fenwick Tree Variants");
+}
+
+void test_dsu_variants()
+{
+    DEBUG_SECTION("🔗 DSU Variants Testing");
+    TIMER_START(dsu_variants_test);
+
+    DEBUG_FUNC();
+    mt19937 rng(13);
+    auto merge_labels = [](vi &label, int a, int b)
+    {
+        int from = label[b], to = label[a];
+        if (from == to)
+            return false;
+        for (int &x : label)
+            if (x == from)
+                x = to;
+        return true;
+    };
+
+    INFO("Checking the single-array DSU against naive labels...");
+    const int n = 300;
+    DSU dsu(n);
+    vi label(n);
+    iota(all(label), 0);
+    int sets = n;
+    f(op, 0, 3000)
+    {
+        int a = rng() % n, b = rng() % n;
+        bool merged = merge_labels(label, a, b);
+        sets -= merged;
+        ASSERT(dsu.unite(a, b) == merged, "DSU: unite return value mismatch");
+        int c = rng() % n;
+        ASSERT(dsu.connected(a, c) == (label[a] == label[c]), "DSU: connected mismatch");
+        ASSERT(dsu.size(c) == count(all(label), label[c]), "DSU: size mismatch");
+        ASSERT(dsu.num_sets() == sets, "DSU: num_sets mismatch");
+    }
+    DSU chain(1'000'000);
+    f(i, 1, 1'000'000) chain.unite(i - 1, i);
+    ASSERT(chain.size(0) == 1'000'000 && chain.num_sets() == 1, "DSU: Large chain should form one set");
+
+    INFO("Checking RollbackDSU snapshots...");
+    RollbackDSU rb(n);
+    iota(all(label), 0);
+    vector<pair<int, vi>> saved; // (snapshot, labels at that time)
+    f(op, 0, 3000)
+    {
+        int kind = rng() % 10;
+        if (kind < 6)
+        {
+            int a = rng() % n, b = rng() % n;
+            bool merged = merge_labels(label, a, b);
+            ASSERT(rb.unite(a, b) == merged, "RollbackDSU: unite return value mismatch");
+        }
+        else if (kind < 8)
+            saved.pb(rb.snapshot(), label);
+        else if (!saved.empty())
+        {
+            int which = rng() % sz(saved);
+            rb.rollback(saved[which].fi);
+            label = saved[which].se;
+            saved.resize(which + 1);
+        }
+        int a = rng() % n, b = rng() % n;
+        ASSERT(rb.connected(a, b) == (label[a] == label[b]), "RollbackDSU: connected mismatch");
+        ASSERT(rb.size(a) == count(all(label), label[a]), "RollbackDSU: size mismatch");
+        ASSERT(rb.num_sets() == sz(set<int>(all(label))), "RollbackDSU: num_sets mismatch");
+    }
+
+    TIMER_END(dsu_variants_test);
+    TEST_PASS("DSU Variants");
+}
+
+void test_offline_dynamic_connectivity()
+{
+    DEBUG_SECTION("⏳ Offline Dynamic Connectivity Testing");
+    TIMER_START(dynamic_connectivity_test);
+
+    DEBUG_FUNC();
+    mt19937 rng(14);
+    for (int n : {1, 2, 8, 40})
+    {
+        OfflineDynamicConnectivity odc(n);
+        vector<pii> live; // Multiset of present edges
+        vi expected;
+        f(op, 0, 1500)
+        {
+            int kind = rng() % 10;
+            if (kind < 4 || live.empty())
+            {
+                int u = rng() % n, v = rng() % n;
+                odc.add_edge(u, v);
+                live.pb(u, v);
+            }
+            else if (kind < 6)
+            {
+                int idx = rng() % sz(live);
+                odc.remove_edge(live[idx].se, live[idx].fi); // Either orientation works
+                live.erase(live.begin() + idx);
+            }
+            else
+            {
+                DSU naive(n);
+                forV(live) naive.unite(e.fi, e.se);
+                if (kind < 9)
+                {
+                    int u = rng() % n, v = rng() % n;
+                    ASSERT(odc.query_connected(u, v) == sz(expected), "OfflineDynamicConnectivity: Query index mismatch");
+                    expected.pb(naive.connected(u, v));
+                }
+                else
+                {
+                    odc.query_num_sets();
+                    expected.pb(naive.num_sets());
+                }
+            }
+        }
+        ASSERT(odc.solve() == expected, "OfflineDynamicConnectivity: Answers mismatch");
+    }
+
+    TIMER_END(dynamic_connectivity_test);
+    TEST_PASS("Offline Dynamic Connectivity");
+}
+
+void test_csr_graph()
+{
+    DEBUG_SECTION("🗂️ CSR Graph Testing");
+    TIMER_START(csr_graph_test);
+
+    DEBUG_FUNC();
+    mt19937 rng(15);
+    INFO("Comparing CSR overloads against the adjacency-list versions...");
+    for (int n : {1, 2, 30, 400})
+    {
+        const int m = n * 3;
+        vector<tuple<int, int, int>> wedges;
+        vector<pii> edges;
+        vector<vector<pii>> adj(n), adj01(n);
+        vector<vi> plain(n);
+        f(i, 0, m)
+        {
+            int u = rng() % n, v = rng() % n, w = rng() % 100;
+            wedges.eb(u, v, w);
+            edges.eb(u, v);
+            adj[u].eb(v, w), adj[v].eb(u, w);
+            adj01[u].eb(v, w % 2), adj01[v].eb(u, w % 2);
+            plain[u].pb(v), plain[v].pb(u);
+        }
+        auto g = CSRGraph<int>::from_weighted_edges(n, wedges);
+        auto g01 = CSRGraph<int>::from_adjacency(adj01);
+        auto gu = CSRGraph<>::from_edges(n, edges);
+        ASSERT(g.num_edges() == 2 * m && gu.num_edges() == 2 * m, "CSRGraph: Edge count mismatch");
+        f(u, 0, n)
+        {
+            vi a(all(gu.neighbors(u))), b = plain[u];
+            sort(all(a)), sort(all(b));
+            ASSERT(a == b, "CSRGraph: Neighbor set mismatch");
+            ASSERT(gu.degree(u) == sz(plain[u]), "CSRGraph: Degree mismatch");
+        }
+        int s = rng() % n;
+        ASSERT(dijkstra(s, g) == dijkstra(s, n, adj), "CSRGraph: dijkstra mismatch");
+        ASSERT(bfs01(s, g01) == bfs01(s, n, adj01), "CSRGraph: bfs01 mismatch");
+        ASSERT(bfs_distances(gu, s) == bfs_distances(plain, s, n), "CSRGraph: BFS mismatch");
+        ASSERT(connected_components(gu) == connected_components(plain, n), "CSRGraph: Components mismatch");
+        vi parent;
+        vi order = dfs_preorder(gu, s, &parent);
+        vi comp = connected_components(gu);
+        ASSERT(sz(order) == count(all(comp), comp[s]), "CSRGraph: DFS does not cover the component");
+        vi seen(n, 0);
+        forV(order)
+        {
+            ASSERT(e == s || seen[parent[e]], "CSRGraph: DFS visits a node before its parent");
+            seen[e] = 1;
+        }
+
+        vector<pii> tree;
+        f(v, 1, n) tree.eb(static_cast<int>(rng() % v), v);
+        auto gt = CSRGraph<>::from_edges(n, tree);
+        LCA reference(n), lca;
+        HLD hld_ref(n), hld;
+        for (auto [u, v] : tree)
+            reference.add_edge(u, v), hld_ref.add_edge(u, v);
+        reference.build(0);
+        lca.build(gt, 0, LCA::EULER_TOUR);
+        hld_ref.build(0);
+        hld.build(gt, 0);
+        ASSERT(hld.pos == hld_ref.pos && hld.head == hld_ref.head, "CSRGraph: HLD decomposition mismatch");
+        f(q, 0, 300)
+        {
+            int u = rng() % n, v = rng() % n;
+            ASSERT(lca.get_lca(u, v) == reference.get_lca(u, v), "CSRGraph: LCA mismatch");
+            ASSERT(hld.get_lca_internal(u, v) == reference.get_lca(u, v), "CSRGraph: HLD LCA mismatch");
+        }
+    }
+
+    TIMER_END(csr_graph_test);
+    TEST_PASS("CSR Graph");
+}
+
+void test_dijkstra_heaps()
+{
+    DEBUG_SECTION("🛣️ Dijkstra Heap Testing");
+    TIMER_START(dijkstra_heaps_test);
+
+    DEBUG_FUNC();
+    mt19937 rng(16);
+    INFO("Heaps pop in key order...");
+    {
+        RadixHeap radix;
+        IndexedDaryHeap<3> dary(200);
+        vll keys(200);
+        f(v, 0, 200)
+        {
+            keys[v] = rng() % 1000 + (v % 7 == 0 ? (1LL << 40) : 0);
+            radix.push(v, keys[v]);
+            dary.push(v, keys[v] + 5);
+            dary.push(v, keys[v]); // Decrease-key
+        }
+        vll sorted_keys = keys;
+        sort(all(sorted_keys));
+        f(i, 0, 200)
+        {
+            ASSERT(radix.pop().fi == sorted_keys[i], "RadixHeap: Pop order mismatch");
+            ASSERT(dary.pop().fi == sorted_keys[i], "IndexedDaryHeap: Pop order mismatch");
+        }
+        ASSERT(radix.empty() && dary.empty(), "Heaps: Not empty after popping everything");
+    }
+
+    INFO("Comparing heap choices, multi-source and early exit against Bellman-Ford...");
+    for (int n : {1, 2, 50, 300})
+    {
+        vector<vector<pii>> adj(n);
+        vector<tuple<int, int, int>> edges;
+        f(i, 0, 4 * n)
+        {
+            int u = rng() % n, v = rng() % n, w = (i % 3 == 0) ? 0 : rng() % 1'000'000;
+            adj[u].eb(v, w);
+            edges.eb(u, v, w);
+        }
+        auto g = CSRGraph<int>::from_weighted_edges(n, edges, true);
+        vi sources = {static_cast<int>(rng() % n), static_cast<int>(rng() % n)};
+        vector<ll> expected(n, INF);
+        forV(sources) expected[e] = 0;
+        f(round, 0, n) for (auto [u, v, w] : edges)
+        {
+            if (expected[u] != INF)
+                expected[v] = min(expected[v], expected[u] + w);
+        }
+        for (DijkstraHeap heap : {BINARY_HEAP, RADIX_HEAP, DARY_HEAP})
+        {
+            ASSERT(dijkstra_from(sources, n, adj, heap) == expected, "dijkstra_from: Distance mismatch");
+            ASSERT(dijkstra_from(sources, n, g, heap) == expected, "dijkstra_from: CSR distance mismatch");
+            vector<ll> single = dijkstra(sources[0], n, adj, heap);
+            ASSERT(single == dijkstra(sources[0], g, heap), "dijkstra: CSR single-source mismatch");
+            int target = rng() % n;
+            ASSERT(dijkstra(sources[0], n, adj, heap, target)[target] == single[target], "dijkstra: Early exit mismatch");
+        }
+    }
+
+    TIMER_END(dijkstra_heaps_test);
+    TEST_PASS("Dijkstra Heaps");
+}
+
+void test_shortest_path_batch()
+{
+    DEBUG_SECTION("🧵 Batch Shortest Path Testing");
+    TIMER_START(shortest_path_batch_test);
+
+    DEBUG_FUNC();
+    mt19937 rng(17);
+    INFO("Comparing batch runners against single-source searches...");
+    for (int n : {1, 40, 500})
+    {
+        vector<vector<pii>> adj(n), adj01(n);
+        f(i, 0, 3 * n)
+        {
+            int u = rng() % n, v = rng() % n, w = rng() % 1000;
+            adj[u].eb(v, w), adj01[u].eb(v, w % 2);
+        }
+        auto g = CSRGraph<int>::from_adjacency(adj);
+        vi sources(37);
+        for (int &x : sources)
+            x = rng() % n;
+        for (int threads : {1, 4})
+        {
+            for (DijkstraHeap heap : {BINARY_HEAP, RADIX_HEAP, DARY_HEAP})
+            {
+                vector<vector<ll>> streamed(sz(sources));
+                dijkstra_batch(sources, n, g, [&](int i, const vector<ll> &dist) { streamed[i] = dist; }, heap, threads);
+                vector<ll> matrix = dijkstra_batch_matrix(sources, n, adj, heap, threads);
+                f(i, 0, sz(sources))
+                {
+                    vector<ll> expected = dijkstra(sources[i], n, adj);
+                    ASSERT(streamed[i] == expected, "dijkstra_batch: Distance mismatch");
+                    ASSERT(equal(all(expected), matrix.begin() + i * n), "dijkstra_batch_matrix: Distance mismatch");
+                }
+            }
+            vector<vector<ll>> streamed(sz(sources));
+            bfs01_batch(sources, n, adj01, [&](int i, const vector<ll> &dist) { streamed[i] = dist; }, threads);
+            vector<ll> matrix = bfs01_batch_matrix(sources, n, adj01, threads);
+            f(i, 0, sz(sources))
+            {
+                vector<ll> expected = bfs01(sources[i], n, adj01);
+                ASSERT(streamed[i] == expected, "bfs01_batch: Distance mismatch");
+                ASSERT(equal(all(expected), matrix.begin() + i * n), "bfs01_batch_matrix: Distance mismatch");
+            }
+        }
+    }
+
+    TIMER_END(shortest_path_batch_test);
+    TEST_PASS("Batch Shortest Paths");
+}
+
+void test_dinic_max_flow()
+{
+    DEBUG_SECTION("🚰 Dinic Max Flow Testing");
+    TIMER_START(dinic_test);
+
+    DEBUG_FUNC();
+    {
+        DinicMaxFlow mf(4);
+        mf.add_edge(0, 1, 3), mf.add_edge(0, 2, 2), mf.add_edge(1, 2, 5), mf.add_edge(1, 3, 2), mf.add_edge(2, 3, 3);
+        ASSERT(mf.get_max_flow(0, 3) == 5, "DinicMaxFlow: Small example mismatch");
+    }
+
+    INFO("Checking conservation and min-cut certificates on random graphs...");
+    mt19937 rng(18);
+    f(iter, 0, 200)
+    {
+        const int n = 2 + rng() % 12, m = rng() % 40;
+        vector<tuple<int, int, ll>> edges;
+        f(i, 0, m)
+        {
+            ll c = (iter % 2) ? static_cast<ll>(rng() % 1'000'000'000) : static_cast<ll>(rng() % 5);
+            edges.eb(rng() % n, rng() % n, c);
+        }
+        ll answers[2];
+        for (bool scaling : {false, true})
+        {
+            DinicMaxFlow mf(n);
+            for (auto [u, v, c] : edges)
+                mf.add_edge(u, v, c);
+            ll flow = mf.get_max_flow(0, n - 1, scaling);
+            answers[scaling] = flow;
+            vll balance(n, 0);
+            ll cut = 0;
+            vector<bool> side = mf.min_cut(0);
+            ASSERT(side[0] && !side[n - 1], "DinicMaxFlow: Min cut does not separate s and t");
+            f(i, 0, m)
+            {
+                auto [u, v, c] = edges[i];
+                ll x = mf.flow(i);
+                ASSERT(x >= 0 && x <= c, "DinicMaxFlow: Edge flow outside [0, capacity]");
+                balance[u] -= x, balance[v] += x;
+                if (side[u] && !side[v])
+                    cut += c;
+            }
+            f(u, 1, n - 1) ASSERT(balance[u] == 0, "DinicMaxFlow: Flow not conserved");
+            ASSERT(balance[n - 1] == flow && cut == flow, "DinicMaxFlow: Flow differs from min cut");
+        }
+        ASSERT(answers[0] == answers[1], "DinicMaxFlow: Capacity scaling changes the answer");
+
+        // Edges added after a run keep the existing flow; the second run only adds the increment
+        DinicMaxFlow incremental(n);
+        f(i, 0, m / 2) incremental.add_edge(get<0>(edges[i]), get<1>(edges[i]), get<2>(edges[i]));
+        ll first = incremental.get_max_flow(0, n - 1);
+        f(i, m / 2, m) incremental.add_edge(get<0>(edges[i]), get<1>(edges[i]), get<2>(edges[i]));
+        ASSERT(first + incremental.get_max_flow(0, n - 1) == answers[0], "DinicMaxFlow: Incremental flow mismatch");
+    }
+
+    TIMER_END(dinic_test);
+    TEST_PASS("Dinic Max Flow");
+}
+
+void test_min_cost_flow()
+{
+    DEBUG_SECTION("💸 Min-Cost Flow Testing");
+    TIMER_START(min_cost_flow_test);
+
+    DEBUG_FUNC();
+    // Reference: successive shortest paths with Bellman-Ford on a plain residual edge list
+    auto naive = [](int n, const vector<array<ll, 4>> &edges, int s, int t, ll limit)
+    {
+        vector<array<ll, 4>> arcs; // {to, cap, cost, from}
+        for (auto [u, v, c, w] : edges)
+        {
+            arcs.push_back({v, c, w, u});
+            arcs.push_back({u, 0, -w, v});
+        }
+        ll flow = 0, cost = 0;
+        while (flow < limit)
+        {
+            vll dist(n, INF);
+            vi via(n, -1);
+            dist[s] = 0;
+            f(round, 0, n) f(k, 0, sz(arcs))
+            {
+                auto [v, c, w, u] = arcs[k];
+                if (c > 0 && dist[u] != INF && dist[u] + w < dist[v])
+                    dist[v] = dist[u] + w, via[v] = k;
+            }
+            if (dist[t] == INF)
+                break;
+            ll pushed = limit - flow;
+            for (int v = t; v != s; v = arcs[via[v]][3])
+                pushed = min(pushed, arcs[via[v]][1]);
+            for (int v = t; v != s; v = arcs[via[v]][3])
+                arcs[via[v]][1] -= pushed, arcs[via[v] ^ 1][1] += pushed;
+            flow += pushed, cost += pushed * dist[t];
+        }
+        return pll(flow, cost);
+    };
+
+    INFO("Comparing SSP (every heap) and cost scaling against a Bellman-Ford reference...");
+    mt19937 rng(19);
+    f(iter, 0, 150)
+    {
+        const int n = 2 + rng() % 9, m = rng() % 30;
+        const bool negative = iter % 3 == 0; // Negative costs only on a DAG (u < v): no negative cycles
+        vector<array<ll, 4>> edges;
+        f(i, 0, m)
+        {
+            int u = rng() % n, v = rng() % n;
+            ll w = static_cast<ll>(rng() % 20);
+            if (negative)
+            {
+                if (u > v)
+                    swap(u, v);
+                w -= 10;
+            }
+            edges.push_back({u, v, static_cast<ll>(rng() % 6), w});
+        }
+        ll limit = (iter % 2) ? INF : static_cast<ll>(rng() % 8);
+        pll expected = naive(n, edges, 0, n - 1, limit);
+        for (int variant : {0, 1, 2, 3})
+        {
+            MinCostFlow mcf(n);
+            for (auto [u, v, c, w] : edges)
+                mcf.add_edge(u, v, c, w);
+            mcf.heap = variant == 1 ? RADIX_HEAP : variant == 2 ? BINARY_HEAP : DARY_HEAP;
+            auto method = variant == 3 ? MinCostFlow::COST_SCALING : MinCostFlow::SUCCESSIVE_SHORTEST_PATHS;
+            pll got = mcf.get_min_cost_flow(0, n - 1, limit, method);
+            ASSERT(got == expected, "MinCostFlow: {flow, cost} mismatch");
+            ASSERT(mcf.total_cost() == expected.se, "MinCostFlow: total_cost mismatch");
+            const FlowNetwork &g = mcf.net;
+            f(u, 0, n) f(k, g.start[u], g.start[u + 1])
+            {
+                if (g.cap[k] > 0)
+                    ASSERT(g.cost[k] + mcf.potential[u] - mcf.potential[g.to[k]] >= 0, "MinCostFlow: Potential is not a feasible dual");
+            }
+        }
+    }
+
+    INFO("Two-step SSP continues from the residual network...");
+    {
+        MinCostFlow mcf(4);
+        mcf.add_edge(0, 1, 2, 1), mcf.add_edge(0, 2, 2, 5), mcf.add_edge(1, 3, 1, 1), mcf.add_edge(2, 3, 3, 1), mcf.add_edge(1, 2, 2, 1);
+        ASSERT(mcf.get_min_cost_flow(0, 3, 1) == pll(1, 2), "MinCostFlow: First unit");
+        ASSERT(mcf.get_min_cost_flow(0, 3) == pll(3, 3 + 6 + 6), "MinCostFlow: Remaining units");
+        ASSERT(mcf.total_cost() == 17, "MinCostFlow: Accumulated cost");
+    }
+
+    TIMER_END(min_cost_flow_test);
+    TEST_PASS("Min-Cost Flow");
+}
+
 void run_comprehensive_tests()
 {
     DEBUG_SECTION("🧪 COMPREHENSIVE TEMPLATE TESTING");
     
     INFO("Starting template component verification...");
     
-    PROGRESS(0, 6);
+    PROGRESS(0, 25);
     test_dsu();
-    PROGRESS(1, 6);
+    PROGRESS(1, 25);
     
     test_fenwick();
-    PROGRESS(2, 6);
+    PROGRESS(2, 25);
     
     test_geometry();
-    PROGRESS(3, 6);
+    PROGRESS(3, 25);
     
     test_string_algorithms();
-    PROGRESS(4, 6);
+    PROGRESS(4, 25);
     
     test_number_theory();
-    PROGRESS(5, 6);
+    PROGRESS(5, 25);
     
     test_modular_arithmetic();
-    PROGRESS(6, 6);
+    PROGRESS(6, 25);
+    
+    test_fast_reader();
+    PROGRESS(7, 25);
+    
+    test_fast_writer();
+    PROGRESS(8, 25);
+    
+    test_modint();
+    PROGRESS(9, 25);
+    
+    test_ntt();
+    PROGRESS(10, 25);
+    
+    test_ntt_arbitrary_mod();
+    PROGRESS(11, 25);
+    
+    test_formal_power_series();
+    PROGRESS(12, 25);
+    
+    test_lca();
+    PROGRESS(13, 25);
+    
+    test_lca_batch();
+    PROGRESS(14, 25);
+    
+    test_lazy_segtree();
+    PROGRESS(15, 25);
+    
+    test_segtree_search_and_beats();
+    PROGRESS(16, 25);
+    
+    test_persistent_segtree();
+    PROGRESS(17, 25);
+    
+    test_fenwick_variants();
+    PROGRESS(18, 25);
+    
+    test_dsu_variants();
+    PROGRESS(19, 25);
+    
+    test_offline_dynamic_connectivity();
+    PROGRESS(20, 25);
+    
+    test_csr_graph();
+    PROGRESS(21, 25);
+    
+    test_dijkstra_heaps();
+    PROGRESS(22, 25);
+    
+    test_shortest_path_batch();
+    PROGRESS(23, 25);
+    
+    test_dinic_max_flow();
+    PROGRESS(24, 25);
+    
+    test_min_cost_flow();
+    PROGRESS(25, 25);
     
     SUCCESS("🎉 ALL TESTS COMPLETED SUCCESSFULLY! 🎉");
 }